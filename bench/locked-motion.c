@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Cost per event of the motion fast path for locked pointers, see
+ * src/locked-motion.c. Run with:
+ *
+ *   meson test -C build --benchmark
+ *
+ * No client is connected, so this measures the compositor side only:
+ * idle notification and looking up the relative pointers of the focused
+ * client.
+ */
+#include <stdio.h>
+#include <time.h>
+#include <wayland-server-core.h>
+#include <wlr/types/wlr_pointer.h>
+#include <wlr/types/wlr_relative_pointer_v1.h>
+#include <wlr/types/wlr_seat.h>
+#include <wlr/util/log.h>
+#include "idle.h"
+#include "labwc.h"
+#include "locked-motion.h"
+
+#define NR_EVENTS (1000000)
+
+static struct server server;
+
+static int64_t
+now_nsec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+int
+main(void)
+{
+	wlr_log_init(WLR_ERROR, NULL);
+
+	server.wl_display = wl_display_create();
+	server.relative_pointer_manager =
+		wlr_relative_pointer_manager_v1_create(server.wl_display);
+	server.seat.server = &server;
+	server.seat.seat = wlr_seat_create(server.wl_display, "seat0");
+	idle_manager_create(server.wl_display, server.seat.seat);
+
+	struct wlr_pointer_motion_event event = {
+		.delta_x = 1.0,
+		.delta_y = -1.0,
+		.unaccel_dx = 1.0,
+		.unaccel_dy = -1.0,
+	};
+
+	int64_t start = now_nsec();
+	for (uint32_t i = 0; i < NR_EVENTS; i++) {
+		/* 1000 Hz polling rate */
+		event.time_msec = i;
+		locked_motion_notify(&server.seat, &event);
+	}
+	int64_t end = now_nsec();
+
+	printf("locked_motion events=%d ns_per_event=%.1f\n", NR_EVENTS,
+		(double)(end - start) / NR_EVENTS);
+
+	wlr_seat_destroy(server.seat.seat);
+	wl_display_destroy(server.wl_display);
+	return 0;
+}
@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_HISTOGRAM_H
+#define LABWC_HISTOGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Number of most recent samples that a histogram keeps */
+#define HISTOGRAM_WINDOW (256)
+
+/*
+ * Rolling histogram of unsigned integer samples (typically durations in
+ * microseconds). Only the last HISTOGRAM_WINDOW samples are kept so that
+ * percentiles and bucket counts reflect recent behaviour rather than the
+ * whole session. The total number of samples ever added is kept as well.
+ */
+struct histogram {
+	uint32_t samples[HISTOGRAM_WINDOW];
+	uint32_t next;
+	uint32_t len;
+	uint64_t total;
+};
+
+/**
+ * histogram_add - add sample to histogram
+ * @value: sample to add; the oldest sample is dropped if the window is full
+ */
+void histogram_add(struct histogram *histogram, uint32_t value);
+
+/**
+ * histogram_percentile - get percentile of samples in the current window
+ * @percentile: 0 to 100, where 100 returns the largest sample
+ * Returns 0 if the histogram is empty.
+ */
+uint32_t histogram_percentile(struct histogram *histogram, int percentile);
+
+/**
+ * histogram_last - get the most recently added sample
+ * Returns 0 if the histogram is empty.
+ */
+uint32_t histogram_last(struct histogram *histogram);
+
+/**
+ * histogram_print - write histogram as a single line
+ * @prefix: string printed at the start of the line, typically the name
+ * @bounds: ascending (inclusive) upper bounds of the buckets
+ * @nr_bounds: number of elements in @bounds
+ *
+ * The line has the format:
+ *   <prefix> total=N p50=N p95=N p99=N max=N le<bound>=N ... inf=N
+ * which is meant to be easy to parse by external tools.
+ */
+void histogram_print(struct histogram *histogram, FILE *stream,
+	const char *prefix, const uint32_t *bounds, size_t nr_bounds);
+
+#endif /* LABWC_HISTOGRAM_H */
@@ -37,5 +37,30 @@ uint32_t parse_modifier(const char *symname);
 
 bool keybind_the_same(struct keybind *a, struct keybind *b);
 
+/**
+ * keybind_deduplicate - remove keybinds replaced by a later one and
+ * keybinds without actions from rc.keybinds
+ */
+void keybind_deduplicate(void);
+
+/**
+ * keybind_update_keycodes - find keycodes for the keysyms of all keybinds
+ * Also indexes the keybinds by keycode for keybind_lookup().
+ */
 void keybind_update_keycodes(struct server *server);
+
+/**
+ * keybind_table_build - index rc.keybinds by keysym for keybind_lookup()
+ * Must be called whenever rc.keybinds has changed.
+ */
+void keybind_table_build(void);
+void keybind_table_finish(void);
+
+/**
+ * keybind_lookup - find the first keybind in rc.keybinds matching a key
+ * @sym: keysym to look up, or XKB_KEY_NoSymbol to look up @code instead
+ * @toggle_only: only consider keybinds containing ToggleKeybinds
+ */
+struct keybind *keybind_lookup(uint32_t modifiers, xkb_keysym_t sym,
+	xkb_keycode_t code, bool toggle_only);
 #endif /* LABWC_KEYBIND_H */
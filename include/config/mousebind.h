@@ -50,4 +50,33 @@ enum direction mousebind_direction_from_str(const char *str, uint32_t *modifiers
 struct mousebind *mousebind_create(const char *context);
 bool mousebind_the_same(struct mousebind *a, struct mousebind *b);
 
+/**
+ * mousebind_table_build - index rc.mousebinds for event dispatch
+ * Must be called whenever rc.mousebinds has changed.
+ */
+void mousebind_table_build(void);
+void mousebind_table_finish(void);
+
+/**
+ * mousebind_lookup_button - find non-scroll bindings matching an event
+ * @context: type of the part under the cursor (see get_cursor_context())
+ * Returns an array of struct mousebind pointers in configuration order, or
+ * NULL if there are none. The mouse event type is not taken into account.
+ */
+struct wl_array *mousebind_lookup_button(uint32_t button, uint32_t modifiers,
+	enum ssd_part_type context);
+
+/**
+ * mousebind_lookup_scroll - find scroll bindings matching an event
+ * Same as mousebind_lookup_button() for scroll directions.
+ */
+struct wl_array *mousebind_lookup_scroll(enum direction direction,
+	uint32_t modifiers, enum ssd_part_type context);
+
+/* Returns an array of pointers to all drag bindings, or NULL */
+struct wl_array *mousebind_drag_bindings(void);
+
+/* Clear pressed_in_context of all bindings for @button */
+void mousebind_clear_pressed(uint32_t button);
+
 #endif /* LABWC_MOUSEBIND_H */
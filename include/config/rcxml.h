@@ -26,6 +26,18 @@ struct usable_area_override {
 	struct wl_list link; /* struct rcxml.usable_area_overrides */
 };
 
+/* Values of output_config.max_render_time other than a time in ms */
+#define LAB_RENDER_TIME_UNSET (-2)
+#define LAB_RENDER_TIME_AUTO (-1)
+#define LAB_RENDER_TIME_OFF (0)
+
+struct output_config {
+	char *name; /* NULL applies to all outputs */
+	int max_render_time;
+	char *mirror; /* name of the output to mirror */
+	struct wl_list link; /* struct rcxml.output_configs */
+};
+
 struct window_switcher_field {
 	enum window_switcher_field_content content;
 	int width;
@@ -40,11 +52,13 @@ struct rcxml {
 	int gap;
 	bool adaptive_sync;
 	bool reuse_output_mode;
+	bool exclusive_fullscreen;
 
 	/* focus */
 	bool focus_follow_mouse;
 	bool focus_follow_mouse_requires_movement;
 	bool raise_on_focus;
+	int raise_on_focus_delay;  /* in ms */
 
 	/* theme */
 	char *theme_name;
@@ -59,6 +73,9 @@ struct rcxml {
 	/* <margin top="" bottom="" left="" right="" output="" /> */
 	struct wl_list usable_area_overrides;
 
+	/* <outputs><output name="" maxRenderTime="" /></outputs> */
+	struct wl_list output_configs;
+
 	/* keyboard */
 	int repeat_rate;
 	int repeat_delay;
@@ -80,6 +97,7 @@ struct rcxml {
 	bool snap_top_maximize;
 
 	enum resize_indicator_mode resize_indicator;
+	bool resize_snapshot;
 
 	struct {
 		int popuptime;
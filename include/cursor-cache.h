@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_CURSOR_CACHE_H
+#define LABWC_CURSOR_CACHE_H
+
+#include <stdbool.h>
+#include "cursor.h"
+
+/*
+ * Cache of the labwc cursor images for every output scale in use.
+ *
+ * The xcursor theme of each scale is loaded ahead of time on a background
+ * thread and the images of all labwc cursors are looked up once, so that
+ * setting a cursor image never has to load a theme or search it by name.
+ * Until the theme of a new scale is available, outputs with that scale
+ * show the (smaller) images of scale 1.
+ */
+
+/**
+ * cursor_cache_init - set up the cache from the scale 1 theme
+ * @names: xcursor names indexed by enum lab_cursors
+ *
+ * The scale 1 theme must already be loaded into seat->xcursor_manager.
+ */
+void cursor_cache_init(struct seat *seat, const char * const *names);
+
+/**
+ * cursor_cache_update_scales - start loading themes for new output scales
+ * Called whenever outputs are added or their scale may have changed.
+ */
+void cursor_cache_update_scales(struct seat *seat);
+
+/**
+ * cursor_cache_set_image - set cursor image for outputs of all scales
+ */
+void cursor_cache_set_image(struct seat *seat, enum lab_cursors cursor);
+
+/**
+ * cursor_cache_finish - wait for pending loads and free the cache
+ * Must be called before seat->xcursor_manager is destroyed.
+ */
+void cursor_cache_finish(struct seat *seat);
+
+#endif /* LABWC_CURSOR_CACHE_H */
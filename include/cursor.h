@@ -64,6 +64,13 @@ struct cursor_context {
  */
 struct cursor_context get_cursor_context(struct server *server);
 
+/**
+ * get_cursor_context_cached - like get_cursor_context() but may return
+ * the result of the previous lookup if neither the cursor position nor
+ * server->scene_generation have changed since.
+ */
+struct cursor_context get_cursor_context_cached(struct server *server);
+
 /**
  * cursor_set - set cursor icon
  * @seat - current seat
@@ -104,9 +111,19 @@ enum lab_cursors cursor_get_from_edge(uint32_t resize_edges);
  * This can be used to give the mouse focus to the surface under the cursor
  * or to force an update of the cursor icon by sending an exit and enter
  * event to an already focused surface.
+ *
+ * The update is deferred until the event loop becomes idle so that any
+ * number of requests within one dispatch cycle are resolved only once.
+ * Use cursor_flush_focus() if the result is needed right away.
  */
 void cursor_update_focus(struct server *server);
 
+/**
+ * cursor_flush_focus - resolve a pending cursor_update_focus() request now
+ * @server - server
+ */
+void cursor_flush_focus(struct server *server);
+
 /**
  * cursor_update_image - re-set the labwc cursor image
  * @seat - seat
@@ -117,6 +134,14 @@ void cursor_update_focus(struct server *server);
  */
 void cursor_update_image(struct seat *seat);
 
+/**
+ * cursor_flush_motion - process pending pointer motion
+ * Motion events are accumulated until the end of the pointer frame. This
+ * must be called before handling any event whose outcome depends on the
+ * surface under the cursor having been updated.
+ */
+void cursor_flush_motion(struct seat *seat);
+
 void cursor_init(struct seat *seat);
 void cursor_finish(struct seat *seat);
 
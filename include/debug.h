@@ -6,4 +6,18 @@ struct server;
 
 void debug_dump_scene(struct server *server);
 
+/**
+ * debug_dump_stats - print runtime statistics
+ * The statistics are printed to stdout and also written to
+ * $XDG_RUNTIME_DIR/labwc-$WAYLAND_DISPLAY.stats for use by external tools.
+ */
+void debug_dump_stats(struct server *server);
+
+/**
+ * debug_toggle_damage - toggle highlighting of damaged regions
+ * Each region that is re-rendered is tinted and fades out over a short
+ * time, which makes redundant redraws easy to spot.
+ */
+void debug_toggle_damage(struct server *server);
+
 #endif /* LABWC_DEBUG_H */
@@ -20,7 +20,6 @@ struct drag_icon {
 };
 
 void dnd_init(struct seat *seat);
-void dnd_icons_show(struct seat *seat, bool show);
 void dnd_icons_move(struct seat *seat, double x, double y);
 void dnd_finish(struct seat *seat);
 
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_FRAME_STATS_H
+#define LABWC_FRAME_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "common/histogram.h"
+
+struct wlr_output_event_present;
+
+/*
+ * Per-output frame timing statistics. Commits are recorded from the output
+ * frame handler and presentation events from the wlr_output present signal
+ * which also drives wp_presentation feedback.
+ */
+struct frame_stats {
+	/* Time spent in wlr_scene_output_commit() in usec */
+	struct histogram commit_time;
+	/* Time between two consecutive presented frames in usec */
+	struct histogram frame_interval;
+	/* Number of vblanks missed between commit and presentation */
+	struct histogram missed_vblanks;
+
+	uint64_t nr_commits;
+	uint64_t nr_presented;
+	uint64_t nr_discarded;
+	uint64_t nr_missed_vblanks;
+	/* Frames which were scanned out directly from a client buffer */
+	uint64_t nr_scanout;
+	uint64_t nr_composited;
+
+	struct timespec last_commit;
+	struct timespec last_present;
+	bool commit_pending;
+};
+
+/**
+ * frame_stats_timespec_diff_usec - return b - a in microseconds
+ * Returns 0 if b is before a.
+ */
+uint32_t frame_stats_timespec_diff_usec(const struct timespec *a,
+	const struct timespec *b);
+
+/**
+ * frame_stats_record_commit - record a frame commit
+ * @start: time before the commit
+ * @end: time after the commit has completed
+ */
+void frame_stats_record_commit(struct frame_stats *stats,
+	const struct timespec *start, const struct timespec *end);
+
+/**
+ * frame_stats_record_present - record a wlr_output present event
+ * @event: data of the wlr_output present signal
+ */
+void frame_stats_record_present(struct frame_stats *stats,
+	struct wlr_output_event_present *event);
+
+/**
+ * frame_stats_print - write statistics in a line based key=value format
+ * @name: output name to prefix each line with
+ */
+void frame_stats_print(struct frame_stats *stats, FILE *stream,
+	const char *name);
+
+#endif /* LABWC_FRAME_STATS_H */
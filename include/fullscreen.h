@@ -0,0 +1,31 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_FULLSCREEN_H
+#define LABWC_FULLSCREEN_H
+
+struct output;
+struct server;
+
+/**
+ * fullscreen_update - re-evaluate exclusive fullscreen state of all outputs
+ * When <core><exclusiveFullscreen> is enabled and the focused view is
+ * fullscreen, all other views and output specific scene-trees on its output
+ * are disabled so that the client buffer can be scanned out directly.
+ * Anything disabled is restored once the view loses focus or leaves
+ * fullscreen, or a layer surface on the output gets keyboard focus.
+ *
+ * Adaptive sync is likewise enabled on outputs with a focused fullscreen
+ * view matching an adaptiveSync window rule and restored afterwards.
+ */
+void fullscreen_update(struct server *server);
+
+/**
+ * fullscreen_update_output - re-evaluate exclusive fullscreen state of output
+ */
+void fullscreen_update_output(struct output *output);
+
+/**
+ * fullscreen_on_output_destroy - restore everything hidden for output
+ */
+void fullscreen_on_output_destroy(struct output *output);
+
+#endif /* LABWC_FULLSCREEN_H */
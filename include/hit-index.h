@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_HIT_INDEX_H
+#define LABWC_HIT_INDEX_H
+
+#include <stdbool.h>
+#include <wayland-util.h>
+
+struct output;
+struct server;
+struct view;
+
+/*
+ * Per-output grid of the views intersecting each cell, used to narrow
+ * pointer hit-testing down to the few views under the cursor instead of
+ * walking the scene-nodes of every view.
+ */
+
+/**
+ * hit_index_query - get views which may contain point (lx, ly)
+ * The returned array contains struct view pointers in no particular order
+ * and is valid until the next call. Returns NULL if the point is not on any
+ * output, in which case the caller has to test all views.
+ */
+struct wl_array *hit_index_query(struct server *server, double lx, double ly);
+
+/**
+ * hit_index_view_damage - update the cells of view
+ * Must be called when the view has been moved, resized, mapped or unmapped,
+ * its decorations have changed or its surface was committed.
+ * Returns true if the bounds of the view may have changed.
+ */
+bool hit_index_view_damage(struct view *view);
+
+void hit_index_on_view_destroy(struct view *view);
+void hit_index_on_output_destroy(struct output *output);
+
+/**
+ * hit_index_on_layout_change - rebuild all grids on the next query
+ */
+void hit_index_on_layout_change(struct server *server);
+
+#endif /* LABWC_HIT_INDEX_H */
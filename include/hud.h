@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_HUD_H
+#define LABWC_HUD_H
+
+struct output;
+struct server;
+
+/**
+ * hud_toggle - show or hide the performance HUD on all outputs
+ * The HUD shows the frame rate, the duration of the last commit, the
+ * event-loop busy time, the number of scene nodes and the number of mapped
+ * views. It is updated a few times per second.
+ */
+void hud_toggle(struct server *server);
+
+/**
+ * hud_on_output_destroy - destroy the HUD of output
+ */
+void hud_on_output_destroy(struct output *output);
+
+void hud_finish(struct server *server);
+
+#endif /* LABWC_HUD_H */
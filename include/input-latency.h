@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_INPUT_LATENCY_H
+#define LABWC_INPUT_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "common/histogram.h"
+
+struct output;
+
+/*
+ * Per-device input latency statistics. Events are recorded when their
+ * handler is called and presentation from the wlr_output present signal
+ * of the first frame committed after that on the output showing the
+ * result of the event. Events which cause no frame on that output are
+ * not counted.
+ */
+struct input_latency {
+	/*
+	 * Time between the kernel timestamp of an event and its dispatch,
+	 * in usec but with a resolution of one millisecond
+	 */
+	struct histogram event_to_dispatch;
+	/* Time between dispatch and presentation of the next frame */
+	struct histogram dispatch_to_present;
+
+	/* Dispatch time of the oldest event not presented yet */
+	struct timespec pending_dispatch;
+	/* Output expected to be damaged by that event */
+	struct output *pending_output;
+	bool pending;
+};
+
+/**
+ * input_latency_record_event - record dispatch of an input event
+ * @time_msec: timestamp of the event as provided by wlroots
+ * @output: output expected to be damaged by the event, may be NULL
+ */
+void input_latency_record_event(struct input_latency *latency,
+	uint32_t time_msec, struct output *output);
+
+/**
+ * input_latency_record_present - record presentation of a frame
+ * @output: output which presented the frame
+ * @commit: time the frame was committed
+ * @when: time the frame was presented
+ *
+ * A pending event for @output dispatched before @commit is shown by this
+ * frame.
+ */
+void input_latency_record_present(struct input_latency *latency,
+	struct output *output, const struct timespec *commit,
+	const struct timespec *when);
+
+void input_latency_on_output_destroy(struct input_latency *latency,
+	struct output *output);
+
+/**
+ * input_latency_print - write statistics in a line based key=value format
+ * @name: device name to prefix each line with
+ */
+void input_latency_print(struct input_latency *latency, FILE *stream,
+	const char *name);
+
+#endif /* LABWC_INPUT_LATENCY_H */
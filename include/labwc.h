@@ -44,6 +44,8 @@
 #include "cursor.h"
 #include "config/keybind.h"
 #include "config/rcxml.h"
+#include "frame-stats.h"
+#include "input-latency.h"
 #include "regions.h"
 #include "session-lock.h"
 #if HAVE_NLS
@@ -77,6 +79,7 @@ struct input {
 	struct seat *seat;
 	struct wl_listener destroy;
 	struct wl_list link; /* seat::inputs */
+	struct input_latency latency;
 };
 
 /*
@@ -174,6 +177,24 @@ struct seat {
 	struct wl_listener cursor_axis;
 	struct wl_listener cursor_frame;
 
+	/*
+	 * Pointer motion is processed once per pointer frame rather than
+	 * for every motion event, see cursor_flush_motion()
+	 */
+	struct {
+		bool pending;
+		uint32_t time_msec;
+		struct wl_event_source *idle;
+		uint64_t nr_events;
+		uint64_t nr_collapsed;
+	} motion;
+
+	/*
+	 * Focus updates requested by cursor_update_focus() are coalesced
+	 * and resolved once from an idle callback, see cursor_flush_focus()
+	 */
+	struct wl_event_source *focus_idle;
+
 	struct wlr_pointer_gestures_v1 *pointer_gestures;
 	struct wl_listener pinch_begin;
 	struct wl_listener pinch_update;
@@ -201,6 +222,8 @@ struct seat {
 	struct wl_listener virtual_keyboard_new;
 };
 
+struct hit_index;
+struct hud;
 struct lab_data_buffer;
 struct workspace;
 
@@ -249,6 +272,12 @@ struct server {
 	struct view *focused_view;
 	struct ssd_hover_state *ssd_hover_state;
 
+	/* Raise delayed by <focus><raiseOnFocusDelay> */
+	struct {
+		struct view *view;
+		struct wl_event_source *timer;
+	} pending_raise;
+
 	/* Tree for all non-layer xdg/xwayland-shell surfaces */
 	struct wlr_scene_tree *view_tree;
 
@@ -286,8 +315,25 @@ struct server {
 	 * to be ignored (to prevent, for example, moving views in a
 	 * transitory layout state).  Once the counter reaches zero,
 	 * do_output_layout_change() must be called explicitly.
+	 *
+	 * The layout pass itself is deferred for a short time so that a
+	 * burst of hotplug events results in a single pass. The counter is
+	 * held while the pass is scheduled.
 	 */
 	int pending_output_layout_change;
+	struct wl_event_source *output_layout_change_timer;
+	bool output_layout_change_scheduled;
+
+	/* Set when the output layout has changed, see src/hit-index.c */
+	bool hit_index_dirty;
+
+	/*
+	 * Incremented whenever the scene changes in a way that may affect
+	 * what is under the cursor (nodes moved, resized, restacked, mapped,
+	 * unmapped or destroyed). Used to invalidate the cursor context that
+	 * cursor_update_focus() caches, see src/desktop.c
+	 */
+	uint64_t scene_generation;
 
 	struct session_lock *session_lock;
 
@@ -337,6 +383,33 @@ struct output {
 
 	struct wl_listener destroy;
 	struct wl_listener frame;
+	struct wl_listener present;
+	struct wl_listener commit;
+
+	struct frame_stats frame_stats;
+
+	/* Defers rendering to just before the next vblank (maxRenderTime) */
+	struct wl_event_source *render_timer;
+	int auto_render_time;
+	uint64_t auto_render_time_commits;
+
+	/* Focused fullscreen view in exclusive fullscreen mode */
+	struct view *exclusive_view;
+	/* Bitmask of trees enabled before entering exclusive fullscreen */
+	uint32_t exclusive_saved_enabled;
+	/* Adaptive sync is enabled by an adaptiveSync window rule */
+	bool adaptive_sync_by_rule;
+	/* Adaptive sync state to restore once the rule no longer applies */
+	bool adaptive_sync_saved;
+	/* Name of the output mirrored by this one, NULL if not a mirror */
+	char *mirror_of;
+	bool mirror_needs_frame;
+	/* Last committed buffer, only kept while this output is mirrored */
+	struct wlr_buffer *mirror_buffer;
+	/* Performance HUD, NULL unless enabled */
+	struct hud *hud;
+	/* Grid of views for hit-testing, built on first use */
+	struct hit_index *hit_index;
 
 	bool leased;
 };
@@ -371,6 +444,19 @@ void foreign_toplevel_update_outputs(struct view *view);
  *              or pointer focus, in this compositor are they called together.
  */
 void desktop_focus_and_activate_view(struct seat *seat, struct view *view);
+
+/**
+ * desktop_raise_on_focus - raise view focused by hovering it
+ * The view is raised once it has been hovered for <raiseOnFocusDelay>
+ * milliseconds, or right away if no delay is configured.
+ */
+void desktop_raise_on_focus(struct view *view);
+
+/**
+ * desktop_cancel_raise - cancel a delayed raise
+ * @view: only cancel if this view is pending, or any view if NULL
+ */
+void desktop_cancel_raise(struct server *server, struct view *view);
 void desktop_arrange_all_views(struct server *server);
 void desktop_focus_output(struct output *output);
 struct view *desktop_topmost_mapped_view(struct server *server);
@@ -411,12 +497,31 @@ void seat_set_pressed(struct seat *seat, struct view *view,
 	struct wlr_surface *toplevel, uint32_t resize_edges);
 void seat_reset_pressed(struct seat *seat);
 
+/**
+ * seat_record_input_event - record input latency of an event
+ * @device: device which emitted the event
+ * @time_msec: timestamp of the event
+ */
+void seat_record_input_event(struct seat *seat,
+	struct wlr_input_device *device, uint32_t time_msec);
+
+/**
+ * seat_record_present - record presentation of a frame for input latency
+ * @output: output which presented the frame
+ * @commit: time the frame was committed
+ * @when: time the frame was presented
+ */
+void seat_record_present(struct seat *seat, struct output *output,
+	const struct timespec *commit, const struct timespec *when);
+void seat_on_output_destroy(struct seat *seat, struct output *output);
+
 void interactive_begin(struct view *view, enum input_mode mode, uint32_t edges);
 void interactive_finish(struct view *view);
 void interactive_cancel(struct view *view);
 
 void output_init(struct server *server);
 void output_manager_init(struct server *server);
+void output_finish(struct server *server);
 struct output *output_from_wlr_output(struct server *server,
 	struct wlr_output *wlr_output);
 struct output *output_from_name(struct server *server, const char *name);
@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_LOCKED_MOTION_H
+#define LABWC_LOCKED_MOTION_H
+
+struct seat;
+struct wlr_pointer_motion_event;
+
+/**
+ * locked_motion_notify - handle motion of a pointer locked by a client
+ * Only relative motion is sent. The cursor does not move, so there is
+ * nothing to hit-test and no focus or SSD hover state to update.
+ *
+ * Kept apart from src/cursor.c so that bench/locked-motion.c can measure
+ * the cost per event without setting up the rest of the compositor.
+ */
+void locked_motion_notify(struct seat *seat,
+	struct wlr_pointer_motion_event *event);
+
+#endif /* LABWC_LOCKED_MOTION_H */
@@ -0,0 +1,35 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_MIRROR_H
+#define LABWC_MIRROR_H
+
+struct output;
+struct wlr_output_event_commit;
+
+/**
+ * mirror_init - set up output as mirror target if configured in rc.xml
+ * Sets output->mirror_of if <outputs><output mirror=""> names another
+ * output. Mirror targets are not added to the output layout.
+ */
+void mirror_init(struct output *output);
+
+/**
+ * mirror_handle_commit - keep buffer committed on a mirror source
+ * Schedules a frame on every output mirroring @output.
+ */
+void mirror_handle_commit(struct output *output,
+	struct wlr_output_event_commit *event);
+
+/**
+ * mirror_render - draw the last frame of the source onto a mirror target
+ * The frame is scaled to fit the target and letterboxed if the aspect
+ * ratios differ. Nothing is drawn if the source has not committed a new
+ * frame since the last call.
+ */
+void mirror_render(struct output *output);
+
+/**
+ * mirror_on_output_destroy - release mirror state of output
+ */
+void mirror_on_output_destroy(struct output *output);
+
+#endif /* LABWC_MIRROR_H */
@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_MODE_CACHE_H
+#define LABWC_MODE_CACHE_H
+
+struct wlr_output;
+struct wlr_output_mode;
+
+/*
+ * Cache of the last mode that was committed successfully for each output,
+ * identified by make, model and serial number. It is kept in
+ * $XDG_STATE_HOME/labwc/output-modes (~/.local/state/labwc/output-modes if
+ * unset) so that it persists across hotplugs and sessions.
+ */
+
+/**
+ * mode_cache_lookup - find the cached mode of an output
+ * Returns a mode of @wlr_output or NULL if none is cached or the cached
+ * mode is no longer advertised by the output.
+ */
+struct wlr_output_mode *mode_cache_lookup(struct wlr_output *wlr_output);
+
+/**
+ * mode_cache_store - remember the current mode of an output
+ * Must be called after a successful commit. The cache file is only
+ * rewritten if the entry changed.
+ */
+void mode_cache_store(struct wlr_output *wlr_output);
+
+/**
+ * mode_cache_finish - free memory used by the cache
+ */
+void mode_cache_finish(void);
+
+#endif /* LABWC_MODE_CACHE_H */
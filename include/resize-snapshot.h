@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_RESIZE_SNAPSHOT_H
+#define LABWC_RESIZE_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <wlr/util/box.h>
+
+struct view;
+
+/*
+ * Snapshot-based interactive resize (<resize><snapshot>).
+ *
+ * At the start of an interactive resize, the buffers last committed by
+ * the client are copied into a separate scene-tree. While the size the
+ * client has committed lags behind the geometry requested by the
+ * compositor, the copy is shown stretched to the requested geometry
+ * (and the decorations follow that geometry) instead of the live surface.
+ * The live surface is swapped back in as soon as the client commits a
+ * matching size.
+ *
+ * Only xdg-shell views are supported.
+ */
+
+/**
+ * resize_snapshot_begin - start snapshot mode if enabled in rc.xml
+ * Called when an interactive resize starts.
+ */
+void resize_snapshot_begin(struct view *view);
+
+/**
+ * resize_snapshot_end - show the live surface again and apply its size
+ * Called when an interactive resize finishes or is cancelled.
+ */
+void resize_snapshot_end(struct view *view);
+
+/**
+ * resize_snapshot_destroy - free snapshot without touching the live surface
+ * Called when the view is destroyed.
+ */
+void resize_snapshot_destroy(struct view *view);
+
+/**
+ * resize_snapshot_set_geometry - show the view at @geo
+ * Called for every geometry requested by the compositor in snapshot mode.
+ */
+void resize_snapshot_set_geometry(struct view *view, struct wlr_box geo);
+
+/**
+ * resize_snapshot_handle_commit - process a client commit
+ * @width, @height: size committed by the client
+ */
+void resize_snapshot_handle_commit(struct view *view, int width, int height);
+
+#endif /* LABWC_RESIZE_SNAPSHOT_H */
@@ -97,6 +97,17 @@ struct view {
 	bool fullscreen;
 	uint32_t tiled;  /* private, enum view_edge in src/view.c */
 	bool inhibits_keybinds;
+	/* Set by visibility_update() in src/visibility.c */
+	bool visible;
+	/* Private, see visibility_view_commit() */
+	struct wlr_box opaque_extents;
+	int opaque_nr_rects;
+	/* Output on which an exclusive fullscreen view hides this view */
+	struct output *hidden_by_fullscreen;
+	/* Private, see src/hit-index.c */
+	struct wlr_box hit_bounds;
+	bool hit_bounds_dirty;
+	struct wlr_box hit_box;
 
 	/* Pointer to an output owned struct region, may be NULL */
 	struct region *tiled_region;
@@ -126,8 +137,15 @@ struct view {
 	/* used by xdg-shell views */
 	uint32_t pending_configure_serial;
 	struct wl_event_source *pending_configure_timeout;
+	/*
+	 * Latest geometry requested during interactive resize while a
+	 * configure was still in flight. Sent once the client acks.
+	 */
+	struct wlr_box deferred_configure;
+	bool has_deferred_configure;
 
 	struct ssd *ssd;
+	struct resize_snapshot *resize_snapshot;
 	struct resize_indicator {
 		int width, height;
 		struct wlr_scene_tree *tree;
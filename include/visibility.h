@@ -0,0 +1,44 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+#ifndef LABWC_VISIBILITY_H
+#define LABWC_VISIBILITY_H
+
+#include <time.h>
+
+struct output;
+struct server;
+struct view;
+
+void visibility_init(struct server *server);
+void visibility_finish(struct server *server);
+
+/**
+ * visibility_update - update view->visible for all views
+ * A view is invisible when it is unmapped, minimized, on a disabled
+ * workspace, not on any usable output or completely covered by the opaque
+ * regions of views stacked above it.
+ */
+void visibility_update(struct server *server);
+
+/**
+ * visibility_view_commit - check the opaque region of view for changes
+ * Must be called on surface commit of the view.
+ */
+void visibility_view_commit(struct view *view);
+
+/**
+ * visibility_send_frame_done - send frame-done to surfaces on output
+ * Surfaces of invisible views are skipped. They receive frame-done events
+ * at a low fallback rate instead so that clients do not stall completely.
+ */
+void visibility_send_frame_done(struct output *output, struct timespec *now);
+
+/**
+ * visibility_arm_fallback - make sure the fallback timer is running
+ * Frame events, which normally arm the timer, do not happen while all
+ * outputs are off. This must be called whenever views may have become
+ * invisible without a frame, like on view map/unmap or when outputs are
+ * disabled or destroyed.
+ */
+void visibility_arm_fallback(struct server *server);
+
+#endif /* LABWC_VISIBILITY_H */
@@ -30,6 +30,7 @@ struct window_rule {
 	enum property skip_taskbar;
 	enum property skip_window_switcher;
 	enum property ignore_focus_request;
+	enum property adaptive_sync;
 
 	struct wl_list link; /* struct rcxml.window_rules */
 };
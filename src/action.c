@@ -13,6 +13,7 @@
 #include "common/spawn.h"
 #include "common/string-helpers.h"
 #include "debug.h"
+#include "hud.h"
 #include "labwc.h"
 #include "menu/menu.h"
 #include "regions.h"
@@ -54,6 +55,8 @@ enum action_type {
 	ACTION_TYPE_CLOSE,
 	ACTION_TYPE_KILL,
 	ACTION_TYPE_DEBUG,
+	ACTION_TYPE_DEBUG_DAMAGE,
+	ACTION_TYPE_DEBUG_HUD,
 	ACTION_TYPE_EXECUTE,
 	ACTION_TYPE_EXIT,
 	ACTION_TYPE_MOVE_TO_EDGE,
@@ -90,6 +93,8 @@ const char *action_names[] = {
 	"Close",
 	"Kill",
 	"Debug",
+	"DebugDamage",
+	"DebugHud",
 	"Execute",
 	"Exit",
 	"MoveToEdge",
@@ -558,6 +563,13 @@ actions_run(struct view *activator, struct server *server,
 			break;
 		case ACTION_TYPE_DEBUG:
 			debug_dump_scene(server);
+			debug_dump_stats(server);
+			break;
+		case ACTION_TYPE_DEBUG_DAMAGE:
+			debug_toggle_damage(server);
+			break;
+		case ACTION_TYPE_DEBUG_HUD:
+			hud_toggle(server);
 			break;
 		case ACTION_TYPE_EXECUTE:
 			{
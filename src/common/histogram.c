@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include <stdlib.h>
+#include <string.h>
+#include "common/histogram.h"
+
+void
+histogram_add(struct histogram *histogram, uint32_t value)
+{
+	histogram->samples[histogram->next] = value;
+	histogram->next = (histogram->next + 1) % HISTOGRAM_WINDOW;
+	if (histogram->len < HISTOGRAM_WINDOW) {
+		histogram->len++;
+	}
+	histogram->total++;
+}
+
+static int
+compare_samples(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+
+static uint32_t
+sorted_percentile(uint32_t *sorted, uint32_t len, int percentile)
+{
+	if (!len) {
+		return 0;
+	}
+	uint32_t index = (uint64_t)len * percentile / 100;
+	return sorted[index < len ? index : len - 1];
+}
+
+uint32_t
+histogram_percentile(struct histogram *histogram, int percentile)
+{
+	uint32_t sorted[HISTOGRAM_WINDOW];
+	memcpy(sorted, histogram->samples, histogram->len * sizeof(uint32_t));
+	qsort(sorted, histogram->len, sizeof(uint32_t), compare_samples);
+	return sorted_percentile(sorted, histogram->len, percentile);
+}
+
+uint32_t
+histogram_last(struct histogram *histogram)
+{
+	if (!histogram->len) {
+		return 0;
+	}
+	uint32_t index = (histogram->next + HISTOGRAM_WINDOW - 1)
+		% HISTOGRAM_WINDOW;
+	return histogram->samples[index];
+}
+
+void
+histogram_print(struct histogram *histogram, FILE *stream,
+		const char *prefix, const uint32_t *bounds, size_t nr_bounds)
+{
+	uint32_t len = histogram->len;
+	uint32_t sorted[HISTOGRAM_WINDOW];
+	memcpy(sorted, histogram->samples, len * sizeof(uint32_t));
+	qsort(sorted, len, sizeof(uint32_t), compare_samples);
+
+	fprintf(stream, "%s total=%lu p50=%u p95=%u p99=%u max=%u", prefix,
+		(unsigned long)histogram->total,
+		sorted_percentile(sorted, len, 50),
+		sorted_percentile(sorted, len, 95),
+		sorted_percentile(sorted, len, 99),
+		sorted_percentile(sorted, len, 100));
+
+	/* The samples are sorted, so each bucket is a contiguous range */
+	uint32_t i = 0;
+	for (size_t b = 0; b < nr_bounds; b++) {
+		uint32_t count = 0;
+		while (i < len && sorted[i] <= bounds[b]) {
+			count++;
+			i++;
+		}
+		fprintf(stream, " le%u=%u", bounds[b], count);
+	}
+	fprintf(stream, " inf=%u\n", len - i);
+}
@@ -6,12 +6,192 @@
 #include <stdlib.h>
 #include <string.h>
 #include <wlr/util/log.h>
+#include "action.h"
 #include "common/list.h"
 #include "common/mem.h"
 #include "config/keybind.h"
 #include "config/rcxml.h"
 #include "labwc.h"
 
+/* Number of hash buckets, must be a power of two */
+#define TABLE_SIZE (128)
+
+struct table_entry {
+	uint32_t modifiers;
+	uint32_t key;
+	struct keybind *keybind;
+};
+
+/*
+ * Hash table mapping (modifiers, key) to keybinds. The entries of each
+ * bucket are kept in the order in which they were added, which is the
+ * order of rc.keybinds, so that the first matching entry is the keybind
+ * that a walk of rc.keybinds would have found first.
+ */
+struct keybind_table {
+	struct wl_array buckets[TABLE_SIZE]; /* struct table_entry */
+	bool built;
+};
+
+/* Indexed by lowered keysym and by keycode respectively */
+static struct keybind_table syms_table;
+static struct keybind_table codes_table;
+
+static uint32_t
+hash(uint32_t modifiers, uint32_t key)
+{
+	return ((key ^ (modifiers << 24)) * 2654435761u) % TABLE_SIZE;
+}
+
+static void
+table_init(struct keybind_table *table)
+{
+	for (size_t i = 0; i < TABLE_SIZE; i++) {
+		wl_array_init(&table->buckets[i]);
+	}
+	table->built = true;
+}
+
+static void
+table_release(struct keybind_table *table)
+{
+	if (!table->built) {
+		return;
+	}
+	for (size_t i = 0; i < TABLE_SIZE; i++) {
+		wl_array_release(&table->buckets[i]);
+	}
+	table->built = false;
+}
+
+static void
+table_add(struct keybind_table *table, uint32_t modifiers, uint32_t key,
+		struct keybind *keybind)
+{
+	struct wl_array *bucket = &table->buckets[hash(modifiers, key)];
+	struct table_entry *entry;
+	wl_array_for_each(entry, bucket) {
+		if (entry->keybind == keybind && entry->modifiers == modifiers
+				&& entry->key == key) {
+			return;
+		}
+	}
+	entry = wl_array_add(bucket, sizeof(*entry));
+	if (!entry) {
+		wlr_log(WLR_ERROR, "unable to index keybind");
+		return;
+	}
+	*entry = (struct table_entry){ modifiers, key, keybind };
+}
+
+static struct keybind *
+table_lookup(struct keybind_table *table, uint32_t modifiers, uint32_t key,
+		bool toggle_only)
+{
+	if (!table->built) {
+		return NULL;
+	}
+	struct table_entry *entry;
+	wl_array_for_each(entry, &table->buckets[hash(modifiers, key)]) {
+		if (entry->modifiers != modifiers || entry->key != key) {
+			continue;
+		}
+		if (toggle_only && !actions_contain_toggle_keybinds(
+				&entry->keybind->actions)) {
+			continue;
+		}
+		return entry->keybind;
+	}
+	return NULL;
+}
+
+void
+keybind_table_build(void)
+{
+	table_release(&syms_table);
+	table_init(&syms_table);
+
+	struct keybind *keybind;
+	wl_list_for_each(keybind, &rc.keybinds, link) {
+		for (size_t i = 0; i < keybind->keysyms_len; i++) {
+			table_add(&syms_table, keybind->modifiers,
+				keybind->keysyms[i], keybind);
+		}
+	}
+}
+
+void
+keybind_table_finish(void)
+{
+	table_release(&syms_table);
+	table_release(&codes_table);
+}
+
+struct keybind *
+keybind_lookup(uint32_t modifiers, xkb_keysym_t sym, xkb_keycode_t code,
+		bool toggle_only)
+{
+	if (sym == XKB_KEY_NoSymbol) {
+		return table_lookup(&codes_table, modifiers, code, toggle_only);
+	}
+	return table_lookup(&syms_table, modifiers, xkb_keysym_to_lower(sym),
+		toggle_only);
+}
+
+void
+keybind_deduplicate(void)
+{
+	uint32_t replaced = 0;
+	uint32_t cleared = 0;
+
+	/*
+	 * Walk the keybinds from last to first and drop those which are
+	 * the same as a later one. The later keybinds seen so far are
+	 * indexed by their first keysym.
+	 */
+	struct keybind_table seen;
+	table_init(&seen);
+	struct keybind *keybind, *tmp;
+	wl_list_for_each_reverse_safe(keybind, tmp, &rc.keybinds, link) {
+		uint32_t key = keybind->keysyms_len ? keybind->keysyms[0]
+			: XKB_KEY_NoSymbol;
+		bool same = false;
+		struct table_entry *entry;
+		wl_array_for_each(entry,
+				&seen.buckets[hash(keybind->modifiers, key)]) {
+			if (keybind_the_same(keybind, entry->keybind)) {
+				same = true;
+				break;
+			}
+		}
+		if (same) {
+			wl_list_remove(&keybind->link);
+			action_list_free(&keybind->actions);
+			free(keybind->keysyms);
+			free(keybind);
+			replaced++;
+			continue;
+		}
+		table_add(&seen, keybind->modifiers, key, keybind);
+	}
+	table_release(&seen);
+
+	wl_list_for_each_safe(keybind, tmp, &rc.keybinds, link) {
+		if (wl_list_empty(&keybind->actions)) {
+			wl_list_remove(&keybind->link);
+			free(keybind->keysyms);
+			free(keybind);
+			cleared++;
+		}
+	}
+	if (replaced) {
+		wlr_log(WLR_DEBUG, "Replaced %u keybinds", replaced);
+	}
+	if (cleared) {
+		wlr_log(WLR_DEBUG, "Cleared %u keybinds", cleared);
+	}
+}
+
 uint32_t
 parse_modifier(const char *symname)
 {
@@ -108,6 +288,15 @@ keybind_update_keycodes(struct server *server)
 		wlr_log(WLR_DEBUG, "Found layout %s", xkb_keymap_layout_get_name(keymap, i));
 		xkb_keymap_key_for_each(keymap, update_keycodes_iter, &i);
 	}
+
+	table_release(&codes_table);
+	table_init(&codes_table);
+	wl_list_for_each(keybind, &rc.keybinds, link) {
+		for (size_t i = 0; i < keybind->keycodes_len; i++) {
+			table_add(&codes_table, keybind->modifiers,
+				keybind->keycodes[i], keybind);
+		}
+	}
 }
 
 struct keybind *
@@ -163,3 +163,181 @@ mousebind_create(const char *context)
 	wl_list_init(&m->actions);
 	return m;
 }
+
+/*
+ * Lookup tables for dispatching pointer events, built from rc.mousebinds
+ * whenever the config is (re)loaded. Bindings are grouped into buckets by
+ * button (or scroll direction) and modifiers, and within each bucket by the
+ * ssd_part_type of the event that they match via ssd_part_contains(). An
+ * event then only visits bindings that fully match except for the mouse
+ * event type. All arrays keep the order of rc.mousebinds.
+ */
+struct mousebind_bucket {
+	uint32_t key; /* button or scroll direction */
+	uint32_t modifiers;
+	struct wl_array all; /* struct mousebind * */
+	struct wl_array by_context[LAB_SSD_END_MARKER];
+	struct wl_list link;
+};
+
+static struct {
+	bool built;
+	struct wl_list buttons; /* struct mousebind_bucket.link */
+	struct wl_list scrolls; /* struct mousebind_bucket.link */
+	struct wl_array drags; /* struct mousebind * */
+} table;
+
+static void
+array_add_mousebind(struct wl_array *array, struct mousebind *mousebind)
+{
+	struct mousebind **entry = wl_array_add(array, sizeof(*entry));
+	if (!entry) {
+		wlr_log(WLR_ERROR, "unable to index mousebind");
+		return;
+	}
+	*entry = mousebind;
+}
+
+static struct mousebind_bucket *
+find_bucket(struct wl_list *buckets, uint32_t key, uint32_t modifiers)
+{
+	struct mousebind_bucket *bucket;
+	wl_list_for_each(bucket, buckets, link) {
+		if (bucket->key == key && bucket->modifiers == modifiers) {
+			return bucket;
+		}
+	}
+	return NULL;
+}
+
+static void
+bucket_add(struct wl_list *buckets, uint32_t key, struct mousebind *mousebind)
+{
+	struct mousebind_bucket *bucket =
+		find_bucket(buckets, key, mousebind->modifiers);
+	if (!bucket) {
+		bucket = znew(*bucket);
+		bucket->key = key;
+		bucket->modifiers = mousebind->modifiers;
+		wl_array_init(&bucket->all);
+		for (int i = 0; i < LAB_SSD_END_MARKER; i++) {
+			wl_array_init(&bucket->by_context[i]);
+		}
+		wl_list_append(buckets, &bucket->link);
+	}
+	array_add_mousebind(&bucket->all, mousebind);
+	for (int i = 0; i < LAB_SSD_END_MARKER; i++) {
+		if (ssd_part_contains(mousebind->context, i)) {
+			array_add_mousebind(&bucket->by_context[i], mousebind);
+		}
+	}
+}
+
+static void
+buckets_free(struct wl_list *buckets)
+{
+	struct mousebind_bucket *bucket, *tmp;
+	wl_list_for_each_safe(bucket, tmp, buckets, link) {
+		wl_list_remove(&bucket->link);
+		wl_array_release(&bucket->all);
+		for (int i = 0; i < LAB_SSD_END_MARKER; i++) {
+			wl_array_release(&bucket->by_context[i]);
+		}
+		free(bucket);
+	}
+}
+
+void
+mousebind_table_build(void)
+{
+	mousebind_table_finish();
+	wl_list_init(&table.buttons);
+	wl_list_init(&table.scrolls);
+	wl_array_init(&table.drags);
+	table.built = true;
+
+	uint32_t count = 0;
+	struct mousebind *mousebind;
+	wl_list_for_each(mousebind, &rc.mousebinds, link) {
+		if (mousebind->mouse_event == MOUSE_ACTION_SCROLL) {
+			bucket_add(&table.scrolls, mousebind->direction,
+				mousebind);
+		} else {
+			bucket_add(&table.buttons, mousebind->button, mousebind);
+		}
+		if (mousebind->mouse_event == MOUSE_ACTION_DRAG) {
+			array_add_mousebind(&table.drags, mousebind);
+		}
+		count++;
+	}
+	wlr_log(WLR_DEBUG, "indexed %u mousebinds in %d button and %d "
+		"scroll buckets", count, wl_list_length(&table.buttons),
+		wl_list_length(&table.scrolls));
+}
+
+void
+mousebind_table_finish(void)
+{
+	if (!table.built) {
+		return;
+	}
+	buckets_free(&table.buttons);
+	buckets_free(&table.scrolls);
+	wl_array_release(&table.drags);
+	table.built = false;
+}
+
+static struct wl_array *
+lookup(struct wl_list *buckets, uint32_t key, uint32_t modifiers,
+		enum ssd_part_type context)
+{
+	if (!table.built || context >= LAB_SSD_END_MARKER) {
+		return NULL;
+	}
+	struct mousebind_bucket *bucket = find_bucket(buckets, key, modifiers);
+	if (!bucket || !bucket->by_context[context].size) {
+		return NULL;
+	}
+	return &bucket->by_context[context];
+}
+
+struct wl_array *
+mousebind_lookup_button(uint32_t button, uint32_t modifiers,
+		enum ssd_part_type context)
+{
+	return lookup(&table.buttons, button, modifiers, context);
+}
+
+struct wl_array *
+mousebind_lookup_scroll(enum direction direction, uint32_t modifiers,
+		enum ssd_part_type context)
+{
+	return lookup(&table.scrolls, direction, modifiers, context);
+}
+
+struct wl_array *
+mousebind_drag_bindings(void)
+{
+	if (!table.built || !table.drags.size) {
+		return NULL;
+	}
+	return &table.drags;
+}
+
+void
+mousebind_clear_pressed(uint32_t button)
+{
+	if (!table.built) {
+		return;
+	}
+	struct mousebind_bucket *bucket;
+	wl_list_for_each(bucket, &table.buttons, link) {
+		if (bucket->key != button) {
+			continue;
+		}
+		struct mousebind **mousebind;
+		wl_array_for_each(mousebind, &bucket->all) {
+			(*mousebind)->pressed_in_context = false;
+		}
+	}
+}
@@ -32,6 +32,7 @@
 
 static bool in_regions;
 static bool in_usable_area_override;
+static bool in_output_config;
 static bool in_keybind;
 static bool in_mousebind;
 static bool in_libinput_category;
@@ -39,6 +40,7 @@ static bool in_window_switcher_field;
 static bool in_window_rules;
 
 static struct usable_area_override *current_usable_area_override;
+static struct output_config *current_output_config;
 static struct keybind *current_keybind;
 static struct mousebind *current_mousebind;
 static struct libinput_category *current_libinput_category;
@@ -92,6 +94,44 @@ fill_usable_area_override(char *nodename, char *content)
 	}
 }
 
+static void
+fill_output_config(char *nodename, char *content)
+{
+	if (!strcasecmp(nodename, "output.outputs")) {
+		current_output_config = znew(*current_output_config);
+		current_output_config->max_render_time = LAB_RENDER_TIME_UNSET;
+		wl_list_append(&rc.output_configs, &current_output_config->link);
+		return;
+	}
+	string_truncate_at_pattern(nodename, ".output.outputs");
+	if (!content) {
+		/* nop */
+	} else if (!current_output_config) {
+		wlr_log(WLR_ERROR, "no output-config object");
+	} else if (!strcmp(nodename, "name")) {
+		free(current_output_config->name);
+		current_output_config->name = xstrdup(content);
+	} else if (!strcasecmp(nodename, "maxRenderTime")) {
+		if (!strcasecmp(content, "auto")) {
+			current_output_config->max_render_time =
+				LAB_RENDER_TIME_AUTO;
+		} else if (!strcasecmp(content, "off")) {
+			current_output_config->max_render_time =
+				LAB_RENDER_TIME_OFF;
+		} else if (atoi(content) > 0) {
+			current_output_config->max_render_time = atoi(content);
+		} else {
+			wlr_log(WLR_ERROR, "invalid maxRenderTime '%s'", content);
+		}
+	} else if (!strcasecmp(nodename, "mirror")) {
+		free(current_output_config->mirror);
+		current_output_config->mirror = *content ? xstrdup(content) : NULL;
+	} else {
+		wlr_log(WLR_ERROR, "Unexpected data output-config parser: %s=\"%s\"",
+			nodename, content);
+	}
+}
+
 /* Does a boolean-parse but also allows 'default' */
 static void
 set_property(const char *str, enum property *variable)
@@ -152,6 +192,8 @@ fill_window_rule(char *nodename, char *content)
 		set_property(content, &current_window_rule->skip_window_switcher);
 	} else if (!strcasecmp(nodename, "ignoreFocusRequest")) {
 		set_property(content, &current_window_rule->ignore_focus_request);
+	} else if (!strcasecmp(nodename, "adaptiveSync")) {
+		set_property(content, &current_window_rule->adaptive_sync);
 
 	/* Actions */
 	} else if (!strcmp(nodename, "name.action")) {
@@ -538,6 +580,10 @@ entry(xmlNode *node, char *nodename, char *content)
 	if (in_usable_area_override) {
 		fill_usable_area_override(nodename, content);
 	}
+	if (in_output_config) {
+		fill_output_config(nodename, content);
+		return;
+	}
 	if (in_keybind) {
 		fill_keybind(nodename, content);
 	}
@@ -594,6 +640,8 @@ entry(xmlNode *node, char *nodename, char *content)
 		set_bool(content, &rc.adaptive_sync);
 	} else if (!strcasecmp(nodename, "reuseOutputMode.core")) {
 		set_bool(content, &rc.reuse_output_mode);
+	} else if (!strcasecmp(nodename, "exclusiveFullscreen.core")) {
+		set_bool(content, &rc.exclusive_fullscreen);
 	} else if (!strcmp(nodename, "name.theme")) {
 		rc.theme_name = xstrdup(content);
 	} else if (!strcmp(nodename, "cornerradius.theme")) {
@@ -614,6 +662,13 @@ entry(xmlNode *node, char *nodename, char *content)
 		set_bool(content, &rc.focus_follow_mouse_requires_movement);
 	} else if (!strcasecmp(nodename, "raiseOnFocus.focus")) {
 		set_bool(content, &rc.raise_on_focus);
+	} else if (!strcasecmp(nodename, "raiseOnFocusDelay.focus")) {
+		long delay = strtol(content, NULL, 10);
+		if (delay >= 0) {
+			rc.raise_on_focus_delay = delay;
+		} else {
+			wlr_log(WLR_ERROR, "invalid raiseOnFocusDelay");
+		}
 	} else if (!strcasecmp(nodename, "doubleClickTime.mouse")) {
 		long doubleclick_time_parsed = strtol(content, NULL, 10);
 		if (doubleclick_time_parsed > 0) {
@@ -690,6 +745,8 @@ entry(xmlNode *node, char *nodename, char *content)
 		} else {
 			wlr_log(WLR_ERROR, "Invalid value for <resize popupShow />");
 		}
+	} else if (!strcasecmp(nodename, "snapshot.resize")) {
+		set_bool(content, &rc.resize_snapshot);
 	}
 }
 
@@ -735,6 +792,12 @@ xml_tree_walk(xmlNode *node)
 			in_usable_area_override = false;
 			continue;
 		}
+		if (!strcasecmp((char *)n->name, "outputs")) {
+			in_output_config = true;
+			traverse(n);
+			in_output_config = false;
+			continue;
+		}
 		if (!strcasecmp((char *)n->name, "keybind")) {
 			in_keybind = true;
 			traverse(n);
@@ -804,6 +867,7 @@ rcxml_init(void)
 
 	if (!has_run) {
 		wl_list_init(&rc.usable_area_overrides);
+		wl_list_init(&rc.output_configs);
 		wl_list_init(&rc.keybinds);
 		wl_list_init(&rc.mousebinds);
 		wl_list_init(&rc.libinput_categories);
@@ -825,6 +889,7 @@ rcxml_init(void)
 	rc.focus_follow_mouse = false;
 	rc.focus_follow_mouse_requires_movement = true;
 	rc.raise_on_focus = false;
+	rc.raise_on_focus_delay = 0;
 
 	rc.doubleclick_time = 500;
 	rc.scroll_factor = 1.0;
@@ -840,6 +905,7 @@ rcxml_init(void)
 	rc.window_switcher.outlines = true;
 
 	rc.resize_indicator = LAB_RESIZE_INDICATOR_NEVER;
+	rc.resize_snapshot = false;
 
 	rc.workspace_config.popuptime = INT_MIN;
 	rc.workspace_config.min_nr_workspaces = 1;
@@ -1037,41 +1103,6 @@ deduplicate_mouse_bindings(void)
 	}
 }
 
-static void
-deduplicate_key_bindings(void)
-{
-	uint32_t replaced = 0;
-	uint32_t cleared = 0;
-	struct keybind *current, *tmp, *existing;
-	wl_list_for_each_safe(existing, tmp, &rc.keybinds, link) {
-		wl_list_for_each_reverse(current, &rc.keybinds, link) {
-			if (existing == current) {
-				break;
-			}
-			if (keybind_the_same(existing, current)) {
-				wl_list_remove(&existing->link);
-				action_list_free(&existing->actions);
-				free(existing);
-				replaced++;
-				break;
-			}
-		}
-	}
-	wl_list_for_each_safe(current, tmp, &rc.keybinds, link) {
-		if (wl_list_empty(&current->actions)) {
-			wl_list_remove(&current->link);
-			free(current);
-			cleared++;
-		}
-	}
-	if (replaced) {
-		wlr_log(WLR_DEBUG, "Replaced %u keybinds", replaced);
-	}
-	if (cleared) {
-		wlr_log(WLR_DEBUG, "Cleared %u keybinds", cleared);
-	}
-}
-
 static struct {
 	enum window_switcher_field_content content;
 	int width;
@@ -1115,7 +1146,7 @@ post_processing(void)
 	 * This is required so users are able to remove
 	 * a default binding by using the "None" action.
 	 */
-	deduplicate_key_bindings();
+	keybind_deduplicate();
 	deduplicate_mouse_bindings();
 
 	if (!rc.font_activewindow.name) {
@@ -1299,6 +1330,8 @@ rcxml_read(const char *filename)
 no_config:
 	post_processing();
 	validate();
+	keybind_table_build();
+	mousebind_table_build();
 }
 
 void
@@ -1316,6 +1349,15 @@ rcxml_finish(void)
 		zfree(area);
 	}
 
+	struct output_config *oc, *oc_tmp;
+	wl_list_for_each_safe(oc, oc_tmp, &rc.output_configs, link) {
+		wl_list_remove(&oc->link);
+		zfree(oc->name);
+		zfree(oc->mirror);
+		zfree(oc);
+	}
+
+	keybind_table_finish();
 	struct keybind *k, *k_tmp;
 	wl_list_for_each_safe(k, k_tmp, &rc.keybinds, link) {
 		wl_list_remove(&k->link);
@@ -1324,6 +1366,7 @@ rcxml_finish(void)
 		zfree(k);
 	}
 
+	mousebind_table_finish();
 	struct mousebind *m, *m_tmp;
 	wl_list_for_each_safe(m, m_tmp, &rc.mousebinds, link) {
 		wl_list_remove(&m->link);
@@ -1360,6 +1403,7 @@ rcxml_finish(void)
 
 	/* Reset state vars for starting fresh when Reload is triggered */
 	current_usable_area_override = NULL;
+	current_output_config = NULL;
 	current_keybind = NULL;
 	current_mousebind = NULL;
 	current_libinput_category = NULL;
@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <wlr/types/wlr_xcursor_manager.h>
+#include <wlr/util/log.h>
+#include <wlr/xcursor.h>
+#include "common/mem.h"
+#include "cursor-cache.h"
+#include "labwc.h"
+
+struct scaled_cursors {
+	float scale;
+	/* Images of the labwc cursors, NULL if not available (yet) */
+	struct wlr_xcursor *cursors[LAB_CURSOR_COUNT];
+	struct wl_list link; /* cache.scales */
+
+	/* Background loading of the theme */
+	bool loading;
+	pthread_t thread;
+	char *name;
+	uint32_t size;
+	struct wlr_xcursor_theme *theme;
+};
+
+static struct {
+	struct seat *seat;
+	const char * const *names;
+	struct wl_list scales; /* struct scaled_cursors */
+	struct scaled_cursors *base; /* scale 1 */
+
+	/* Loader threads pass finished entries to the main thread */
+	int pipe_fd[2];
+	struct wl_event_source *pipe_source;
+} cache = {
+	.pipe_fd = { -1, -1 },
+};
+
+static struct wlr_xcursor_manager_theme *
+manager_theme(float scale)
+{
+	struct wlr_xcursor_manager_theme *theme;
+	wl_list_for_each(theme, &cache.seat->xcursor_manager->scaled_themes,
+			link) {
+		if (theme->scale == scale) {
+			return theme;
+		}
+	}
+	return NULL;
+}
+
+static void
+fill_cursors(struct scaled_cursors *entry, struct wlr_xcursor_theme *theme)
+{
+	for (int i = LAB_CURSOR_CLIENT + 1; i < LAB_CURSOR_COUNT; i++) {
+		entry->cursors[i] =
+			wlr_xcursor_theme_get_cursor(theme, cache.names[i]);
+	}
+}
+
+static struct scaled_cursors *
+find_scale(float scale)
+{
+	struct scaled_cursors *entry;
+	wl_list_for_each(entry, &cache.scales, link) {
+		if (entry->scale == scale) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/* Runs on a loader thread, must not touch any compositor state */
+static void *
+load_theme(void *data)
+{
+	struct scaled_cursors *entry = data;
+	entry->theme = wlr_xcursor_theme_load(entry->name,
+		entry->size * entry->scale);
+	if (write(cache.pipe_fd[1], &entry, sizeof(entry)) != sizeof(entry)) {
+		wlr_log_errno(WLR_ERROR, "unable to hand over cursor theme");
+	}
+	return NULL;
+}
+
+/*
+ * Hand the theme over to the xcursor manager, so that it is shared with
+ * other users of the manager and freed together with it.
+ */
+static void
+install_theme(struct scaled_cursors *entry)
+{
+	struct wlr_xcursor_manager_theme *theme = manager_theme(entry->scale);
+	if (theme) {
+		wlr_xcursor_theme_destroy(entry->theme);
+	} else {
+		theme = znew(*theme);
+		theme->scale = entry->scale;
+		theme->theme = entry->theme;
+		wl_list_insert(&cache.seat->xcursor_manager->scaled_themes,
+			&theme->link);
+	}
+	entry->theme = NULL;
+	fill_cursors(entry, theme->theme);
+}
+
+static int
+handle_loaded(int fd, uint32_t mask, void *data)
+{
+	struct scaled_cursors *entry;
+	while (read(fd, &entry, sizeof(entry)) == sizeof(entry)) {
+		pthread_join(entry->thread, NULL);
+		entry->loading = false;
+		zfree(entry->name);
+		if (!entry->theme) {
+			wlr_log(WLR_ERROR, "unable to load cursor theme for "
+				"scale %.2f", entry->scale);
+			continue;
+		}
+		install_theme(entry);
+	}
+
+	/* Replace the scale 1 fallback by the proper image */
+	struct seat *seat = cache.seat;
+	if (seat->server_cursor != LAB_CURSOR_CLIENT) {
+		cursor_cache_set_image(seat, seat->server_cursor);
+	}
+	return 0;
+}
+
+static void
+load_sync(struct scaled_cursors *entry)
+{
+	wlr_xcursor_manager_load(cache.seat->xcursor_manager, entry->scale);
+	struct wlr_xcursor_manager_theme *theme = manager_theme(entry->scale);
+	if (theme) {
+		fill_cursors(entry, theme->theme);
+	}
+}
+
+void
+cursor_cache_init(struct seat *seat, const char * const *names)
+{
+	assert(!cache.seat);
+	cache.seat = seat;
+	cache.names = names;
+	wl_list_init(&cache.scales);
+
+	cache.base = znew(*cache.base);
+	cache.base->scale = 1;
+	wl_list_insert(&cache.scales, &cache.base->link);
+	load_sync(cache.base);
+
+	if (pipe(cache.pipe_fd) < 0) {
+		wlr_log_errno(WLR_ERROR, "unable to create cursor loader pipe");
+		return;
+	}
+	for (int i = 0; i < 2; i++) {
+		fcntl(cache.pipe_fd[i], F_SETFD, FD_CLOEXEC);
+		fcntl(cache.pipe_fd[i], F_SETFL, O_NONBLOCK);
+	}
+	cache.pipe_source = wl_event_loop_add_fd(seat->server->wl_event_loop,
+		cache.pipe_fd[0], WL_EVENT_READABLE, handle_loaded, NULL);
+	if (!cache.pipe_source) {
+		wlr_log(WLR_ERROR, "unable to watch cursor loader pipe");
+	}
+}
+
+void
+cursor_cache_update_scales(struct seat *seat)
+{
+	struct output *output;
+	wl_list_for_each(output, &seat->server->outputs, link) {
+		float scale = output->wlr_output->scale;
+		if (find_scale(scale)) {
+			continue;
+		}
+
+		struct scaled_cursors *entry = znew(*entry);
+		entry->scale = scale;
+		wl_list_insert(cache.scales.prev, &entry->link);
+
+		if (!cache.pipe_source || manager_theme(scale)) {
+			load_sync(entry);
+			continue;
+		}
+
+		struct wlr_xcursor_manager *manager = seat->xcursor_manager;
+		entry->name = manager->name ? xstrdup(manager->name) : NULL;
+		entry->size = manager->size;
+		entry->loading = true;
+		if (pthread_create(&entry->thread, NULL, load_theme, entry)) {
+			wlr_log(WLR_ERROR, "unable to start cursor loader thread");
+			entry->loading = false;
+			zfree(entry->name);
+			load_sync(entry);
+		}
+	}
+}
+
+void
+cursor_cache_set_image(struct seat *seat, enum lab_cursors cursor)
+{
+	assert(cursor > LAB_CURSOR_CLIENT && cursor < LAB_CURSOR_COUNT);
+
+	struct scaled_cursors *entry;
+	wl_list_for_each(entry, &cache.scales, link) {
+		struct wlr_xcursor *xcursor = entry->cursors[cursor];
+		if (!xcursor) {
+			/* Still loading or missing from the theme */
+			xcursor = cache.base->cursors[cursor];
+		}
+		if (!xcursor) {
+			continue;
+		}
+		struct wlr_xcursor_image *image = xcursor->images[0];
+		wlr_cursor_set_image(seat->cursor, image->buffer,
+			image->width * 4, image->width, image->height,
+			image->hotspot_x, image->hotspot_y, entry->scale);
+	}
+}
+
+void
+cursor_cache_finish(struct seat *seat)
+{
+	if (!cache.seat) {
+		return;
+	}
+	struct scaled_cursors *entry, *tmp;
+	wl_list_for_each_safe(entry, tmp, &cache.scales, link) {
+		if (entry->loading) {
+			pthread_join(entry->thread, NULL);
+			if (entry->theme) {
+				wlr_xcursor_theme_destroy(entry->theme);
+			}
+		}
+		wl_list_remove(&entry->link);
+		free(entry->name);
+		free(entry);
+	}
+	cache.base = NULL;
+
+	if (cache.pipe_source) {
+		wl_event_source_remove(cache.pipe_source);
+		cache.pipe_source = NULL;
+	}
+	for (int i = 0; i < 2; i++) {
+		if (cache.pipe_fd[i] >= 0) {
+			close(cache.pipe_fd[i]);
+			cache.pipe_fd[i] = -1;
+		}
+	}
+	cache.seat = NULL;
+}
@@ -11,9 +11,11 @@
 #include "common/mem.h"
 #include "common/scene-helpers.h"
 #include "config/mousebind.h"
+#include "cursor-cache.h"
 #include "dnd.h"
 #include "idle.h"
 #include "labwc.h"
+#include "locked-motion.h"
 #include "menu/menu.h"
 #include "regions.h"
 #include "resistance.h"
@@ -250,8 +252,7 @@ cursor_set(struct seat *seat, enum lab_cursors cursor)
 		return;
 	}
 
-	wlr_xcursor_manager_set_cursor_image(
-		seat->xcursor_manager, cursor_names[cursor], seat->cursor);
+	cursor_cache_set_image(seat, cursor);
 	seat->server_cursor = cursor;
 }
 
@@ -272,8 +273,7 @@ cursor_update_image(struct seat *seat)
 		}
 		return;
 	}
-	wlr_xcursor_manager_set_cursor_image(
-		seat->xcursor_manager, cursor_names[cursor], seat->cursor);
+	cursor_cache_set_image(seat, cursor);
 }
 
 bool
@@ -477,17 +477,25 @@ process_cursor_motion(struct server *server, uint32_t time)
 		dnd_icons_move(seat, seat->cursor->x, seat->cursor->y);
 	}
 
+	if (ctx.view != server->pending_raise.view) {
+		/* The pointer has left the view before it got raised */
+		desktop_cancel_raise(server, NULL);
+	}
 	if (ctx.view && rc.focus_follow_mouse) {
 		desktop_focus_and_activate_view(seat, ctx.view);
 		if (rc.raise_on_focus) {
-			view_move_to_front(ctx.view);
+			desktop_raise_on_focus(ctx.view);
 		}
 	}
 
-	struct mousebind *mousebind;
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (mousebind->mouse_event == MOUSE_ACTION_DRAG
-				&& mousebind->pressed_in_context) {
+	struct wl_array *drags = mousebind_drag_bindings();
+	struct mousebind **drag;
+	if (drags) {
+		wl_array_for_each(drag, drags) {
+			struct mousebind *mousebind = *drag;
+			if (!mousebind->pressed_in_context) {
+				continue;
+			}
 			/*
 			 * Use view and resize edges from the press
 			 * event (not the motion event) to prevent
@@ -516,7 +524,7 @@ _cursor_update_focus(struct server *server)
 	clock_gettime(CLOCK_MONOTONIC, &now);
 
 	/* Focus surface under cursor if it isn't already focused */
-	struct cursor_context ctx = get_cursor_context(server);
+	struct cursor_context ctx = get_cursor_context_cached(server);
 
 	if (ctx.view && rc.focus_follow_mouse
 			&& !rc.focus_follow_mouse_requires_movement
@@ -524,7 +532,7 @@ _cursor_update_focus(struct server *server)
 		/* Prevents changing keyboard focus during A-Tab */
 		desktop_focus_and_activate_view(&server->seat, ctx.view);
 		if (rc.raise_on_focus) {
-			view_move_to_front(ctx.view);
+			desktop_raise_on_focus(ctx.view);
 		}
 	}
 
@@ -532,11 +540,16 @@ _cursor_update_focus(struct server *server)
 		/*cursor_has_moved*/ false);
 }
 
-void
-cursor_update_focus(struct server *server)
+/*
+ * Set while a focus update is being resolved. Requests made meanwhile, for
+ * example via view_move_to_front(), are ignored rather than scheduled again,
+ * as they would otherwise keep the event loop busy with idle callbacks.
+ */
+static bool updating_focus;
+
+static void
+update_focus(struct server *server)
 {
-	/* Prevent recursion via view_move_to_front() */
-	static bool updating_focus = false;
 	if (!updating_focus) {
 		updating_focus = true;
 		_cursor_update_focus(server);
@@ -544,6 +557,47 @@ cursor_update_focus(struct server *server)
 	}
 }
 
+static void
+handle_focus_idle(void *data)
+{
+	struct server *server = data;
+	/* Idle sources are removed automatically once dispatched */
+	server->seat.focus_idle = NULL;
+	update_focus(server);
+}
+
+/*
+ * Stacking, geometry and workspace changes each request a focus update and
+ * a single event often causes several of them. Resolve them all at once
+ * when the event loop becomes idle, so that the node under the cursor is
+ * only looked up once.
+ */
+void
+cursor_update_focus(struct server *server)
+{
+	struct seat *seat = &server->seat;
+	if (seat->focus_idle || updating_focus) {
+		return;
+	}
+	seat->focus_idle = wl_event_loop_add_idle(server->wl_event_loop,
+		handle_focus_idle, server);
+	if (!seat->focus_idle) {
+		update_focus(server);
+	}
+}
+
+void
+cursor_flush_focus(struct server *server)
+{
+	struct seat *seat = &server->seat;
+	if (!seat->focus_idle) {
+		return;
+	}
+	wl_event_source_remove(seat->focus_idle);
+	seat->focus_idle = NULL;
+	update_focus(server);
+}
+
 static void
 warp_cursor_to_constraint_hint(struct seat *seat,
 		struct wlr_pointer_constraint_v1 *constraint)
@@ -677,6 +731,54 @@ cursor_locked(struct seat *seat, struct wlr_pointer *pointer)
 		&& seat->current_constraint->type == WLR_POINTER_CONSTRAINT_V1_LOCKED;
 }
 
+void
+cursor_flush_motion(struct seat *seat)
+{
+	/* Do not apply an outdated focus update after newer input */
+	cursor_flush_focus(seat->server);
+
+	if (!seat->motion.pending) {
+		return;
+	}
+	seat->motion.pending = false;
+	if (seat->motion.idle) {
+		wl_event_source_remove(seat->motion.idle);
+		seat->motion.idle = NULL;
+	}
+	process_cursor_motion(seat->server, seat->motion.time_msec);
+}
+
+static void
+handle_motion_idle(void *data)
+{
+	struct seat *seat = data;
+	/* Idle sources are removed automatically once dispatched */
+	seat->motion.idle = NULL;
+	cursor_flush_motion(seat);
+}
+
+/*
+ * High polling rate mice emit several motion events per pointer frame.
+ * Only the cursor position is updated per event, while the expensive
+ * part (finding the node under the cursor, focus handling and notifying
+ * the client) is done once per frame. Devices that do not send frame
+ * events are handled by flushing from an idle callback.
+ */
+static void
+queue_cursor_motion(struct seat *seat, uint32_t time_msec)
+{
+	seat->motion.nr_events++;
+	if (seat->motion.pending) {
+		seat->motion.nr_collapsed++;
+	}
+	seat->motion.pending = true;
+	seat->motion.time_msec = time_msec;
+	if (!seat->motion.idle) {
+		seat->motion.idle = wl_event_loop_add_idle(
+			seat->server->wl_event_loop, handle_motion_idle, seat);
+	}
+}
+
 static void
 preprocess_cursor_motion(struct seat *seat, struct wlr_pointer *pointer,
 		uint32_t time_msec, double dx, double dy)
@@ -695,7 +797,7 @@ preprocess_cursor_motion(struct seat *seat, struct wlr_pointer *pointer,
 	 * without any input.
 	 */
 	wlr_cursor_move(seat->cursor, &pointer->base, dx, dy);
-	process_cursor_motion(seat->server, time_msec);
+	queue_cursor_motion(seat, time_msec);
 }
 
 static void
@@ -708,6 +810,13 @@ cursor_motion(struct wl_listener *listener, void *data)
 	struct seat *seat = wl_container_of(listener, seat, cursor_motion);
 	struct server *server = seat->server;
 	struct wlr_pointer_motion_event *event = data;
+
+	if (cursor_locked(seat, event->pointer)) {
+		/* Not recorded for input latency, the cursor does not move */
+		locked_motion_notify(seat, event);
+		return;
+	}
+	seat_record_input_event(seat, &event->pointer->base, event->time_msec);
 	idle_manager_notify_activity(seat->seat);
 
 	wlr_relative_pointer_manager_v1_send_relative_motion(
@@ -735,6 +844,7 @@ cursor_motion_absolute(struct wl_listener *listener, void *data)
 		listener, seat, cursor_motion_absolute);
 	struct wlr_pointer_motion_absolute_event *event = data;
 	idle_manager_notify_activity(seat->seat);
+	seat_record_input_event(seat, &event->pointer->base, event->time_msec);
 
 	double lx, ly;
 	wlr_cursor_absolute_to_layout_coords(seat->cursor,
@@ -756,16 +866,17 @@ static bool
 handle_release_mousebinding(struct server *server,
 		struct cursor_context *ctx, uint32_t button)
 {
-	struct mousebind *mousebind;
 	bool consumed_by_frame_context = false;
 
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
 			&server->seat.keyboard_group->keyboard);
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->button == button
-				&& modifiers == mousebind->modifiers) {
+	struct wl_array *candidates =
+		mousebind_lookup_button(button, modifiers, ctx->type);
+	struct mousebind **candidate;
+	if (candidates) {
+		wl_array_for_each(candidate, candidates) {
+			struct mousebind *mousebind = *candidate;
 			switch (mousebind->mouse_event) {
 			case MOUSE_ACTION_RELEASE:
 				break;
@@ -796,11 +907,7 @@ handle_release_mousebinding(struct server *server,
 	 * Clear "pressed" status for all bindings of this mouse button,
 	 * regardless of whether handled or not
 	 */
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (mousebind->button == button) {
-			mousebind->pressed_in_context = false;
-		}
-	}
+	mousebind_clear_pressed(button);
 	return consumed_by_frame_context;
 }
 
@@ -837,17 +944,18 @@ static bool
 handle_press_mousebinding(struct server *server, struct cursor_context *ctx,
 		uint32_t button, uint32_t resize_edges)
 {
-	struct mousebind *mousebind;
 	bool double_click = is_double_click(rc.doubleclick_time, button, ctx->view);
 	bool consumed_by_frame_context = false;
 
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
 			&server->seat.keyboard_group->keyboard);
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->button == button
-				&& modifiers == mousebind->modifiers) {
+	struct wl_array *candidates =
+		mousebind_lookup_button(button, modifiers, ctx->type);
+	struct mousebind **candidate;
+	if (candidates) {
+		wl_array_for_each(candidate, candidates) {
+			struct mousebind *mousebind = *candidate;
 			switch (mousebind->mouse_event) {
 			case MOUSE_ACTION_DRAG: /* fallthrough */
 			case MOUSE_ACTION_CLICK:
@@ -1011,6 +1119,8 @@ cursor_button(struct wl_listener *listener, void *data)
 	struct seat *seat = wl_container_of(listener, seat, cursor_button);
 	struct wlr_pointer_button_event *event = data;
 	idle_manager_notify_activity(seat->seat);
+	seat_record_input_event(seat, &event->pointer->base, event->time_msec);
+	cursor_flush_motion(seat);
 
 	switch (event->state) {
 	case WLR_BUTTON_PRESSED:
@@ -1058,7 +1168,6 @@ static bool
 handle_cursor_axis(struct server *server, struct cursor_context *ctx,
 		struct wlr_pointer_axis_event *event)
 {
-	struct mousebind *mousebind;
 	bool handled = false;
 
 	uint32_t modifiers = wlr_keyboard_get_modifiers(
@@ -1087,11 +1196,12 @@ handle_cursor_axis(struct server *server, struct cursor_context *ctx,
 		return false;
 	}
 
-	wl_list_for_each(mousebind, &rc.mousebinds, link) {
-		if (ssd_part_contains(mousebind->context, ctx->type)
-				&& mousebind->direction == direction
-				&& modifiers == mousebind->modifiers
-				&& mousebind->mouse_event == MOUSE_ACTION_SCROLL) {
+	struct wl_array *candidates =
+		mousebind_lookup_scroll(direction, modifiers, ctx->type);
+	struct mousebind **candidate;
+	if (candidates) {
+		wl_array_for_each(candidate, candidates) {
+			struct mousebind *mousebind = *candidate;
 			handled = true;
 			actions_run(ctx->view, server, &mousebind->actions, /*resize_edges*/ 0);
 		}
@@ -1110,8 +1220,10 @@ cursor_axis(struct wl_listener *listener, void *data)
 	struct seat *seat = wl_container_of(listener, seat, cursor_axis);
 	struct wlr_pointer_axis_event *event = data;
 	struct server *server = seat->server;
+	cursor_flush_motion(seat);
 	struct cursor_context ctx = get_cursor_context(server);
 	idle_manager_notify_activity(seat->seat);
+	seat_record_input_event(seat, &event->pointer->base, event->time_msec);
 
 	/* Bindings swallow mouse events if activated */
 	bool handled = handle_cursor_axis(server, &ctx, event);
@@ -1139,6 +1251,7 @@ cursor_frame(struct wl_listener *listener, void *data)
 	 * between.
 	 */
 	struct seat *seat = wl_container_of(listener, seat, cursor_frame);
+	cursor_flush_motion(seat);
 	/* Notify the client with pointer focus of the frame event. */
 	wlr_seat_pointer_notify_frame(seat->seat);
 }
@@ -1147,6 +1260,7 @@ static void handle_pointer_pinch_begin(struct wl_listener *listener, void *data)
 {
 	struct seat *seat = wl_container_of(listener, seat, pinch_begin);
 	struct wlr_pointer_pinch_begin_event *event = data;
+	cursor_flush_motion(seat);
 	wlr_pointer_gestures_v1_send_pinch_begin(seat->pointer_gestures,
 		seat->seat, event->time_msec, event->fingers);
 }
@@ -1172,6 +1286,7 @@ static void handle_pointer_swipe_begin(struct wl_listener *listener, void *data)
 {
 	struct seat *seat = wl_container_of(listener, seat, swipe_begin);
 	struct wlr_pointer_swipe_begin_event *event = data;
+	cursor_flush_motion(seat);
 	wlr_pointer_gestures_v1_send_swipe_begin(seat->pointer_gestures,
 		seat->seat, event->time_msec, event->fingers);
 }
@@ -1233,6 +1348,7 @@ cursor_init(struct seat *seat)
 			"Cursor theme is missing cursor names, using fallback");
 		cursor_names = cursors_x11;
 	}
+	cursor_cache_init(seat, cursor_names);
 
 	/* Set the initial cursor image so the cursor is visible right away */
 	cursor_set(seat, LAB_CURSOR_DEFAULT);
@@ -1282,6 +1398,15 @@ void cursor_finish(struct seat *seat)
 {
 	/* TODO: either clean up all the listeners or none of them */
 
+	if (seat->motion.idle) {
+		wl_event_source_remove(seat->motion.idle);
+		seat->motion.idle = NULL;
+	}
+	if (seat->focus_idle) {
+		wl_event_source_remove(seat->focus_idle);
+		seat->focus_idle = NULL;
+	}
+
 	wl_list_remove(&seat->cursor_motion.link);
 	wl_list_remove(&seat->cursor_motion_absolute.link);
 	wl_list_remove(&seat->cursor_button.link);
@@ -1298,6 +1423,7 @@ void cursor_finish(struct seat *seat)
 	wl_list_remove(&seat->request_cursor.link);
 	wl_list_remove(&seat->request_set_selection.link);
 
+	cursor_cache_finish(seat);
 	wlr_xcursor_manager_destroy(seat->xcursor_manager);
 	wlr_cursor_destroy(seat->cursor);
 
@@ -1,7 +1,13 @@
 // SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <wlr/types/wlr_damage_ring.h>
 #include <wlr/types/wlr_layer_shell_v1.h>
 #include <wlr/types/wlr_scene.h>
+#include <wlr/version.h>
 #include "common/scene-helpers.h"
+#include "common/string-helpers.h"
 #include "debug.h"
 #include "labwc.h"
 #include "node.h"
@@ -191,3 +197,111 @@ debug_dump_scene(struct server *server)
 	 */
 	last_view = NULL;
 }
+
+static void
+print_stats(struct server *server, FILE *stream)
+{
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		frame_stats_print(&output->frame_stats, stream,
+			output->wlr_output->name);
+	}
+
+	struct seat *seat = &server->seat;
+	fprintf(stream, "seat pointer_motion events=%lu processed=%lu "
+		"collapsed=%lu\n", (unsigned long)seat->motion.nr_events,
+		(unsigned long)(seat->motion.nr_events
+			- seat->motion.nr_collapsed),
+		(unsigned long)seat->motion.nr_collapsed);
+
+	struct input *input;
+	wl_list_for_each(input, &seat->inputs, link) {
+		/* Device names usually contain spaces */
+		char name[128];
+		snprintf(name, sizeof(name), "input:%s",
+			input->wlr_input_device->name);
+		for (char *p = name; *p; p++) {
+			if (*p == ' ') {
+				*p = '_';
+			}
+		}
+		input_latency_print(&input->latency, stream, name);
+	}
+}
+
+/*
+ * The statistics file is replaced atomically so that external tools polling
+ * it never see a partially written file.
+ */
+static void
+write_stats_file(struct server *server)
+{
+	const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+	const char *display = getenv("WAYLAND_DISPLAY");
+	if (!runtime_dir || !display) {
+		return;
+	}
+	char *path = strdup_printf("%s/labwc-%s.stats", runtime_dir, display);
+	char *tmp_path = strdup_printf("%s.tmp", path);
+	if (!path || !tmp_path) {
+		goto out;
+	}
+	FILE *stream = fopen(tmp_path, "w");
+	if (!stream) {
+		wlr_log_errno(WLR_ERROR, "cannot write '%s'", tmp_path);
+		goto out;
+	}
+	print_stats(server, stream);
+	fclose(stream);
+	if (rename(tmp_path, path) < 0) {
+		wlr_log_errno(WLR_ERROR, "cannot rename '%s'", tmp_path);
+		unlink(tmp_path);
+		goto out;
+	}
+	wlr_log(WLR_INFO, "statistics written to '%s'", path);
+out:
+	free(tmp_path);
+	free(path);
+}
+
+void
+debug_dump_stats(struct server *server)
+{
+	print_stats(server, stdout);
+	printf("\n");
+	fflush(stdout);
+	write_stats_file(server);
+}
+
+/*
+ * wlr_scene has no API to change the damage debug mode at runtime. This
+ * relies on wlroots 0.16 internals: scene->debug_damage_option, which is
+ * only meant to be set from WLR_SCENE_DEBUG_DAMAGE at creation, and the
+ * damage ring of the scene output. Check both again when bumping wlroots.
+ */
+#if WLR_VERSION_NUM < ((0 << 16) | (16 << 8)) \
+	|| WLR_VERSION_NUM >= ((0 << 16) | (17 << 8))
+#error "debug_toggle_damage() depends on wlroots 0.16 internals"
+#endif
+
+void
+debug_toggle_damage(struct server *server)
+{
+	struct wlr_scene *scene = server->scene;
+	bool enable = scene->debug_damage_option
+		!= WLR_SCENE_DEBUG_DAMAGE_HIGHLIGHT;
+	scene->debug_damage_option = enable
+		? WLR_SCENE_DEBUG_DAMAGE_HIGHLIGHT : WLR_SCENE_DEBUG_DAMAGE_NONE;
+	wlr_log(WLR_INFO, "damage highlighting %s",
+		enable ? "enabled" : "disabled");
+
+	/* Repaint everything so that no stale highlight is left behind */
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (!output->scene_output) {
+			continue;
+		}
+		wlr_damage_ring_add_whole(&output->scene_output->damage_ring);
+		wlr_output_schedule_frame(output->wlr_output);
+	}
+}
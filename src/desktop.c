@@ -3,7 +3,7 @@
 #include <assert.h>
 #include "common/list.h"
 #include "common/scene-helpers.h"
-#include "dnd.h"
+#include "hit-index.h"
 #include "labwc.h"
 #include "layers.h"
 #include "node.h"
@@ -34,6 +34,71 @@ desktop_arrange_all_views(struct server *server)
 	}
 }
 
+static int
+handle_raise_timer(void *data)
+{
+	struct server *server = data;
+	struct view *view = server->pending_raise.view;
+	server->pending_raise.view = NULL;
+	if (view && view->mapped) {
+		view_move_to_front(view);
+	}
+	return 0;
+}
+
+void
+desktop_raise_on_focus(struct view *view)
+{
+	assert(view);
+	struct server *server = view->server;
+	if (!rc.raise_on_focus_delay) {
+		view_move_to_front(view);
+		return;
+	}
+
+	if (server->pending_raise.view == view) {
+		/* Keep counting from when the pointer entered the view */
+		return;
+	}
+	struct view *topmost =
+		wl_container_of(server->views.next, topmost, link);
+	if (!wl_list_empty(&server->views)
+			&& view_get_root(topmost) == view_get_root(view)) {
+		/*
+		 * Already raised, e.g. moving within the view or a focus
+		 * update following the raise. Raising a view also raises
+		 * its sub-views, so compare the roots.
+		 */
+		desktop_cancel_raise(server, NULL);
+		return;
+	}
+
+	if (!server->pending_raise.timer) {
+		server->pending_raise.timer = wl_event_loop_add_timer(
+			server->wl_event_loop, handle_raise_timer, server);
+		if (!server->pending_raise.timer) {
+			view_move_to_front(view);
+			return;
+		}
+	}
+	server->pending_raise.view = view;
+	wl_event_source_timer_update(server->pending_raise.timer,
+		rc.raise_on_focus_delay);
+}
+
+void
+desktop_cancel_raise(struct server *server, struct view *view)
+{
+	if (!server->pending_raise.view) {
+		return;
+	}
+	if (view && server->pending_raise.view != view) {
+		return;
+	}
+	server->pending_raise.view = NULL;
+	wl_event_source_timer_update(server->pending_raise.timer, 0);
+}
+
 void
 desktop_focus_and_activate_view(struct seat *seat, struct view *view)
 {
@@ -307,25 +372,98 @@ start:
 	return false;
 }
 
-/* TODO: make this less big and scary */
-struct cursor_context
-get_cursor_context(struct server *server)
+static bool
+is_candidate(struct wl_array *candidates, struct view *view)
 {
-	struct cursor_context ret = {.type = LAB_SSD_NONE};
-	struct wlr_cursor *cursor = server->seat.cursor;
+	struct view **candidate;
+	wl_array_for_each(candidate, candidates) {
+		if (*candidate == view) {
+			return true;
+		}
+	}
+	return false;
+}
 
-	/* Prevent drag icons to be on top of the hitbox detection */
-	if (server->seat.drag.active) {
-		dnd_icons_show(&server->seat, false);
+/*
+ * Like wlr_scene_node_at() on a tree holding views (directly or within
+ * workspace trees), but only descends into the scene-trees of candidates.
+ */
+static struct wlr_scene_node *
+view_tree_node_at(struct wlr_scene_tree *tree, struct wl_array *candidates,
+		double lx, double ly, double *sx, double *sy)
+{
+	struct wlr_scene_node *child;
+	wl_list_for_each_reverse(child, &tree->children, link) {
+		if (!child->enabled) {
+			continue;
+		}
+		struct node_descriptor *desc = child->data;
+		struct wlr_scene_node *node;
+		if (desc && desc->type == LAB_NODE_DESC_VIEW) {
+			if (!is_candidate(candidates, desc->data)) {
+				continue;
+			}
+			node = wlr_scene_node_at(child, lx, ly, sx, sy);
+		} else if (child->type == WLR_SCENE_NODE_TREE) {
+			node = view_tree_node_at(lab_scene_tree_from_node(child),
+				candidates, lx, ly, sx, sy);
+		} else {
+			node = wlr_scene_node_at(child, lx, ly, sx, sy);
+		}
+		if (node) {
+			return node;
+		}
 	}
+	return NULL;
+}
 
-	struct wlr_scene_node *node =
-		wlr_scene_node_at(&server->scene->tree.node,
-			cursor->x, cursor->y, &ret.sx, &ret.sy);
+/*
+ * Find the topmost node at the cursor. The view trees are only searched
+ * for views in the hit index cell under the cursor, which avoids visiting
+ * the scene-nodes (mostly SSD parts) of all other views.
+ *
+ * Drag icons are skipped so that they do not hide what is below them.
+ * This avoids having to disable them (and damage their area) for the
+ * lookup on each motion event of a drag.
+ */
+static struct wlr_scene_node *
+scene_node_at(struct server *server, double lx, double ly,
+		double *sx, double *sy)
+{
+	struct wl_array *candidates = hit_index_query(server, lx, ly);
 
-	if (server->seat.drag.active) {
-		dnd_icons_show(&server->seat, true);
+	struct wlr_scene_node *child;
+	wl_list_for_each_reverse(child, &server->scene->tree.children, link) {
+		if (!child->enabled || child == &server->seat.drag.icons->node) {
+			continue;
+		}
+		struct wlr_scene_node *node;
+		if (!candidates) {
+			node = wlr_scene_node_at(child, lx, ly, sx, sy);
+		} else if (child == &server->view_tree->node
+				|| child == &server->view_tree_always_on_top->node
+				|| child == &server->view_tree_always_on_bottom->node) {
+			node = view_tree_node_at(lab_scene_tree_from_node(child),
+				candidates, lx, ly, sx, sy);
+		} else {
+			node = wlr_scene_node_at(child, lx, ly, sx, sy);
+		}
+		if (node) {
+			return node;
+		}
 	}
+	return NULL;
+}
+
+/* TODO: make this less big and scary */
+static struct cursor_context
+find_cursor_context(struct server *server)
+{
+	struct cursor_context ret = {.type = LAB_SSD_NONE};
+	struct wlr_cursor *cursor = server->seat.cursor;
+
+	struct wlr_scene_node *node = scene_node_at(server,
+		cursor->x, cursor->y, &ret.sx, &ret.sy);
 
 	ret.node = node;
 	if (!node) {
@@ -419,3 +557,79 @@ get_cursor_context(struct server *server)
 	return ret;
 }
 
+/*
+ * The result of the last lookup, which cursor_update_focus() reuses as long
+ * as neither the cursor position nor server->scene_generation have changed.
+ * The destroy listeners make sure that the cached node and surface never
+ * dangle, even if a destroy path does not bump the generation.
+ */
+static struct {
+	bool valid;
+	double x, y;
+	uint64_t generation;
+	struct cursor_context ctx;
+	struct wl_listener node_destroy;
+	struct wl_listener surface_destroy;
+} ctx_cache;
+
+static void
+ctx_cache_invalidate(void)
+{
+	if (!ctx_cache.valid) {
+		return;
+	}
+	ctx_cache.valid = false;
+	if (ctx_cache.ctx.node) {
+		wl_list_remove(&ctx_cache.node_destroy.link);
+	}
+	if (ctx_cache.ctx.surface) {
+		wl_list_remove(&ctx_cache.surface_destroy.link);
+	}
+}
+
+static void
+handle_ctx_cache_destroy(struct wl_listener *listener, void *data)
+{
+	ctx_cache_invalidate();
+}
+
+static void
+ctx_cache_store(struct server *server, struct cursor_context *ctx)
+{
+	ctx_cache_invalidate();
+	ctx_cache.ctx = *ctx;
+	ctx_cache.x = server->seat.cursor->x;
+	ctx_cache.y = server->seat.cursor->y;
+	ctx_cache.generation = server->scene_generation;
+	if (ctx->node) {
+		ctx_cache.node_destroy.notify = handle_ctx_cache_destroy;
+		wl_signal_add(&ctx->node->events.destroy,
+			&ctx_cache.node_destroy);
+	}
+	if (ctx->surface) {
+		ctx_cache.surface_destroy.notify = handle_ctx_cache_destroy;
+		wl_signal_add(&ctx->surface->events.destroy,
+			&ctx_cache.surface_destroy);
+	}
+	ctx_cache.valid = true;
+}
+
+struct cursor_context
+get_cursor_context(struct server *server)
+{
+	struct cursor_context ctx = find_cursor_context(server);
+	ctx_cache_store(server, &ctx);
+	return ctx;
+}
+
+struct cursor_context
+get_cursor_context_cached(struct server *server)
+{
+	struct wlr_cursor *cursor = server->seat.cursor;
+	if (ctx_cache.valid && ctx_cache.x == cursor->x
+			&& ctx_cache.y == cursor->y
+			&& ctx_cache.generation == server->scene_generation) {
+		return ctx_cache.ctx;
+	}
+	return get_cursor_context(server);
+}
@@ -159,7 +159,7 @@ handle_drag_destroy(struct wl_listener *listener, void *data)
 	seat_focus_surface(seat, ctx.surface);
 
 	if (ctx.view && rc.raise_on_focus) {
-		view_move_to_front(ctx.view);
+		desktop_raise_on_focus(ctx.view);
 	}
 }
 
@@ -183,12 +183,6 @@ dnd_init(struct seat *seat)
 	 */
 }
 
-void
-dnd_icons_show(struct seat *seat, bool show)
-{
-	wlr_scene_node_set_enabled(&seat->drag.icons->node, show);
-}
-
 void
 dnd_icons_move(struct seat *seat, double x, double y)
 {
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include <wlr/types/wlr_output.h>
+#include "common/array-size.h"
+#include "frame-stats.h"
+
+#define NSEC_PER_SEC 1000000000LL
+
+/* Upper bounds of the histogram buckets, in usec and vblanks respectively */
+static const uint32_t time_bounds[] = {
+	500, 1000, 2000, 4000, 8000, 16667, 33333, 50000, 100000
+};
+static const uint32_t vblank_bounds[] = { 0, 1, 2, 4 };
+
+static int64_t
+timespec_to_nsec(const struct timespec *t)
+{
+	return (int64_t)t->tv_sec * NSEC_PER_SEC + t->tv_nsec;
+}
+
+uint32_t
+frame_stats_timespec_diff_usec(const struct timespec *a,
+		const struct timespec *b)
+{
+	int64_t diff = timespec_to_nsec(b) - timespec_to_nsec(a);
+	if (diff <= 0) {
+		return 0;
+	}
+	diff /= 1000;
+	return diff > UINT32_MAX ? UINT32_MAX : (uint32_t)diff;
+}
+
+void
+frame_stats_record_commit(struct frame_stats *stats,
+		const struct timespec *start, const struct timespec *end)
+{
+	histogram_add(&stats->commit_time,
+		frame_stats_timespec_diff_usec(start, end));
+	stats->nr_commits++;
+	stats->last_commit = *end;
+	stats->commit_pending = true;
+}
+
+void
+frame_stats_record_present(struct frame_stats *stats,
+		struct wlr_output_event_present *event)
+{
+	bool commit_pending = stats->commit_pending;
+	stats->commit_pending = false;
+
+	if (!event->presented) {
+		stats->nr_discarded++;
+		return;
+	}
+	stats->nr_presented++;
+
+	struct timespec last_present = stats->last_present;
+	stats->last_present = *event->when;
+	if (!last_present.tv_sec && !last_present.tv_nsec) {
+		return;
+	}
+	histogram_add(&stats->frame_interval,
+		frame_stats_timespec_diff_usec(&last_present, event->when));
+
+	int64_t refresh = event->refresh;
+	if (!refresh && event->output->refresh > 0) {
+		/* wlr_output->refresh is in mHz */
+		refresh = NSEC_PER_SEC * 1000 / event->output->refresh;
+	}
+	if (!commit_pending || refresh <= 0) {
+		return;
+	}
+
+	/*
+	 * Count the vblanks between the previous and this presentation,
+	 * rounded to absorb timestamp jitter. Those which passed before
+	 * the commit are idle time rather than misses, so a frame committed
+	 * in time for the vblank following it has missed none.
+	 */
+	int64_t interval = timespec_to_nsec(event->when)
+		- timespec_to_nsec(&last_present);
+	int64_t idle = timespec_to_nsec(&stats->last_commit)
+		- timespec_to_nsec(&last_present);
+	int64_t missed = (interval + refresh / 2) / refresh - 1;
+	if (idle > 0) {
+		missed -= idle / refresh;
+	}
+	if (missed < 0) {
+		missed = 0;
+	}
+	histogram_add(&stats->missed_vblanks, (uint32_t)missed);
+	stats->nr_missed_vblanks += missed;
+}
+
+void
+frame_stats_print(struct frame_stats *stats, FILE *stream, const char *name)
+{
+	char prefix[256];
+
+	fprintf(stream, "%s frames commits=%lu presented=%lu discarded=%lu "
+		"missed_vblanks=%lu scanout=%lu composited=%lu\n", name,
+		(unsigned long)stats->nr_commits,
+		(unsigned long)stats->nr_presented,
+		(unsigned long)stats->nr_discarded,
+		(unsigned long)stats->nr_missed_vblanks,
+		(unsigned long)stats->nr_scanout,
+		(unsigned long)stats->nr_composited);
+
+	snprintf(prefix, sizeof(prefix), "%s commit_time_us", name);
+	histogram_print(&stats->commit_time, stream, prefix, time_bounds,
+		ARRAY_SIZE(time_bounds));
+	snprintf(prefix, sizeof(prefix), "%s frame_interval_us", name);
+	histogram_print(&stats->frame_interval, stream, prefix, time_bounds,
+		ARRAY_SIZE(time_bounds));
+	snprintf(prefix, sizeof(prefix), "%s missed_vblanks", name);
+	histogram_print(&stats->missed_vblanks, stream, prefix,
+		vblank_bounds, ARRAY_SIZE(vblank_bounds));
+}
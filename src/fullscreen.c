@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Exclusive fullscreen
+ *
+ * wlroots only scans out a client buffer directly if it is the only node
+ * on the output. A fullscreen view covers everything stacked below it, but
+ * the covered nodes still prevent direct scanout. With exclusive fullscreen
+ * enabled we therefore disable them while a fullscreen view is focused.
+ *
+ * Views matching an adaptiveSync window rule also get adaptive sync enabled
+ * on their output while they are focused and fullscreen.
+ */
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
+#include "fullscreen.h"
+#include "labwc.h"
+#include "ssd.h"
+#include "view.h"
+#include "window-rules.h"
+
+/* Per-output scene-trees disabled in exclusive fullscreen mode */
+static size_t
+get_output_trees(struct output *output, struct wlr_scene_tree **trees)
+{
+	size_t n = 0;
+	trees[n++] = output->layer_tree[ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND];
+	trees[n++] = output->layer_tree[ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM];
+	/* The top layer is handled by set_fullscreen() in src/view.c */
+	trees[n++] = output->layer_tree[ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY];
+	trees[n++] = output->layer_popup_tree;
+	trees[n++] = output->osd_tree;
+	return n;
+}
+
+static struct view *
+get_exclusive_view(struct output *output)
+{
+	if (!rc.exclusive_fullscreen || !output_is_usable(output)) {
+		return NULL;
+	}
+	struct view *view = output->server->focused_view;
+	if (!view || !view->mapped || !view->fullscreen
+			|| view->output != output) {
+		return NULL;
+	}
+	/*
+	 * A layer surface with keyboard focus, for example a launcher or an
+	 * on-screen keyboard, must not be hidden while it takes input
+	 */
+	struct wlr_layer_surface_v1 *layer = output->server->seat.focused_layer;
+	if (layer && layer->output == output->wlr_output) {
+		return NULL;
+	}
+	return view;
+}
+
+/* Views which are partly on other outputs must remain visible there */
+static bool
+view_is_only_on_output(struct view *view, struct output *output)
+{
+	struct server *server = output->server;
+	struct wlr_box box = ssd_max_extents(view);
+	struct output *other;
+	wl_list_for_each(other, &server->outputs, link) {
+		if (other == output || !output_is_usable(other)) {
+			continue;
+		}
+		struct wlr_box other_box, intersection;
+		wlr_output_layout_get_box(server->output_layout,
+			other->wlr_output, &other_box);
+		if (wlr_box_intersection(&intersection, &box, &other_box)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void
+hide_views(struct output *output)
+{
+	struct wlr_box output_box, intersection;
+	wlr_output_layout_get_box(output->server->output_layout,
+		output->wlr_output, &output_box);
+
+	struct view *view;
+	wl_list_for_each(view, &output->server->views, link) {
+		if (view == output->exclusive_view || !view->scene_tree
+				|| !view->scene_tree->node.enabled) {
+			continue;
+		}
+		struct wlr_box box = ssd_max_extents(view);
+		if (!wlr_box_intersection(&intersection, &box, &output_box)
+				|| !view_is_only_on_output(view, output)) {
+			continue;
+		}
+		wlr_scene_node_set_enabled(&view->scene_tree->node, false);
+		view->hidden_by_fullscreen = output;
+		output->server->scene_generation++;
+	}
+}
+
+static void
+restore(struct output *output)
+{
+	struct view *view;
+	wl_list_for_each(view, &output->server->views, link) {
+		if (view->hidden_by_fullscreen != output) {
+			continue;
+		}
+		view->hidden_by_fullscreen = NULL;
+		if (view->scene_tree) {
+			wlr_scene_node_set_enabled(&view->scene_tree->node,
+				view->mapped);
+		}
+	}
+
+	struct wlr_scene_tree *trees[8];
+	size_t nr_trees = get_output_trees(output, trees);
+	for (size_t i = 0; i < nr_trees; i++) {
+		wlr_scene_node_set_enabled(&trees[i]->node,
+			output->exclusive_saved_enabled & (1 << i));
+	}
+	output->exclusive_view = NULL;
+	output->server->scene_generation++;
+}
+
+void
+fullscreen_update_output(struct output *output)
+{
+	struct view *view = get_exclusive_view(output);
+	if (view != output->exclusive_view && output->exclusive_view) {
+		restore(output);
+	}
+	if (!view) {
+		return;
+	}
+
+	if (!output->exclusive_view) {
+		wlr_log(WLR_DEBUG, "exclusive fullscreen on output %s",
+			output->wlr_output->name);
+		struct wlr_scene_tree *trees[8];
+		size_t nr_trees = get_output_trees(output, trees);
+		output->exclusive_saved_enabled = 0;
+		for (size_t i = 0; i < nr_trees; i++) {
+			if (trees[i]->node.enabled) {
+				output->exclusive_saved_enabled |= 1 << i;
+			}
+			wlr_scene_node_set_enabled(&trees[i]->node, false);
+		}
+		output->exclusive_view = view;
+		output->server->scene_generation++;
+	}
+
+	/* Views may have been mapped or moved onto the output meanwhile */
+	hide_views(output);
+}
+
+static struct view *
+get_adaptive_sync_view(struct output *output)
+{
+	if (!output_is_usable(output)) {
+		return NULL;
+	}
+	struct view *view = output->server->focused_view;
+	if (!view || !view->mapped || !view->fullscreen
+			|| view->output != output) {
+		return NULL;
+	}
+	if (window_rules_get_property(view, "adaptiveSync") != LAB_PROP_TRUE) {
+		return NULL;
+	}
+	return view;
+}
+
+static bool
+adaptive_sync_enabled(struct wlr_output *wlr_output)
+{
+	return wlr_output->adaptive_sync_status
+		== WLR_OUTPUT_ADAPTIVE_SYNC_ENABLED;
+}
+
+static void
+set_adaptive_sync(struct output *output, bool enabled, const char *reason)
+{
+	struct wlr_output *wlr_output = output->wlr_output;
+	if (adaptive_sync_enabled(wlr_output) == enabled) {
+		return;
+	}
+
+	/* Test first so that a rejected state never reaches the output */
+	wlr_output_enable_adaptive_sync(wlr_output, enabled);
+	if (!wlr_output_test(wlr_output) || !wlr_output_commit(wlr_output)) {
+		wlr_output_rollback(wlr_output);
+		wlr_log(WLR_INFO, "failed to %s adaptive sync for output %s (%s)",
+			enabled ? "enable" : "disable", wlr_output->name, reason);
+		return;
+	}
+	wlr_log(WLR_INFO, "adaptive sync %s for output %s (%s)",
+		enabled ? "enabled" : "disabled", wlr_output->name, reason);
+}
+
+static void
+update_adaptive_sync(struct output *output)
+{
+	struct view *view = get_adaptive_sync_view(output);
+	if (!!view == output->adaptive_sync_by_rule) {
+		return;
+	}
+
+	if (view) {
+		output->adaptive_sync_saved =
+			adaptive_sync_enabled(output->wlr_output);
+		const char *app_id = view_get_string_prop(view, "app_id");
+		set_adaptive_sync(output, true, app_id ? app_id : "fullscreen");
+	} else {
+		set_adaptive_sync(output, output->adaptive_sync_saved,
+			"fullscreen ended");
+	}
+	output->adaptive_sync_by_rule = !!view;
+}
+
+void
+fullscreen_update(struct server *server)
+{
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		fullscreen_update_output(output);
+		/*
+		 * Not done in fullscreen_update_output() which runs from the
+		 * frame handler where an extra output commit is not allowed.
+		 */
+		if (output->wlr_output->enabled) {
+			update_adaptive_sync(output);
+		}
+	}
+}
+
+void
+fullscreen_on_output_destroy(struct output *output)
+{
+	if (output->exclusive_view) {
+		restore(output);
+	}
+}
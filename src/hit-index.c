@@ -0,0 +1,303 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Spatial index for pointer hit-testing
+ *
+ * Each view is stored in the cells of every output grid that its bounding
+ * box intersects. The bounding box is the union of the maximum SSD extents
+ * and the bounds of all nodes in the view's scene-tree (including
+ * subsurfaces and CSD shadows extending past the window geometry).
+ *
+ * The cells of a view are updated when it is moved, resized, mapped or
+ * unmapped, or its decorations change. Stacking order does not matter as
+ * the candidates are tested in scene order by the caller. The grids are
+ * only rebuilt completely when the output layout changes. The scene-tree
+ * bounds are cached as computing them requires a walk over the view's
+ * nodes.
+ */
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
+#include "common/array-size.h"
+#include "common/mem.h"
+#include "common/scene-helpers.h"
+#include "hit-index.h"
+#include "labwc.h"
+#include "ssd.h"
+#include "view.h"
+
+/* Number of cells in each direction */
+#define HIT_INDEX_GRID_SIZE 8
+
+struct hit_index {
+	struct wlr_box output_box;
+	struct wl_array cells[HIT_INDEX_GRID_SIZE * HIT_INDEX_GRID_SIZE];
+};
+
+static void
+extend_box(struct wlr_box *box, int x, int y, int width, int height)
+{
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+	if (wlr_box_empty(box)) {
+		*box = (struct wlr_box){ x, y, width, height };
+		return;
+	}
+	int x2 = MAX(box->x + box->width, x + width);
+	int y2 = MAX(box->y + box->height, y + height);
+	box->x = MIN(box->x, x);
+	box->y = MIN(box->y, y);
+	box->width = x2 - box->x;
+	box->height = y2 - box->y;
+}
+
+/*
+ * Bounds of all nodes below node, relative to the parent of node. Disabled
+ * nodes are included as they may be enabled without a surface commit, for
+ * example when a view is unminimized. A box which is too large only costs
+ * an extra candidate.
+ */
+static void
+node_bounds(struct wlr_scene_node *node, int x, int y, struct wlr_box *box)
+{
+	x += node->x;
+	y += node->y;
+
+	switch (node->type) {
+	case WLR_SCENE_NODE_TREE: {
+		struct wlr_scene_tree *tree = lab_scene_tree_from_node(node);
+		struct wlr_scene_node *child;
+		wl_list_for_each(child, &tree->children, link) {
+			node_bounds(child, x, y, box);
+		}
+		break;
+	}
+	case WLR_SCENE_NODE_RECT: {
+		struct wlr_scene_rect *rect = wlr_scene_rect_from_node(node);
+		extend_box(box, x, y, rect->width, rect->height);
+		break;
+	}
+	case WLR_SCENE_NODE_BUFFER: {
+		struct wlr_scene_buffer *buffer =
+			wlr_scene_buffer_from_node(node);
+		int width = buffer->dst_width;
+		int height = buffer->dst_height;
+		if ((!width || !height) && buffer->buffer) {
+			width = buffer->buffer->width;
+			height = buffer->buffer->height;
+		}
+		extend_box(box, x, y, width, height);
+		break;
+	}
+	}
+}
+
+static struct wlr_box
+get_view_box(struct view *view)
+{
+	struct wlr_box box = {0};
+	if (!view->mapped || !view->scene_tree) {
+		return box;
+	}
+	if (view->hit_bounds_dirty) {
+		view->hit_bounds = (struct wlr_box){0};
+		node_bounds(&view->scene_tree->node, -view->scene_tree->node.x,
+			-view->scene_tree->node.y, &view->hit_bounds);
+		view->hit_bounds_dirty = false;
+	}
+
+	int lx, ly;
+	wlr_scene_node_coords(&view->scene_tree->node, &lx, &ly);
+	box = view->hit_bounds;
+	box.x += lx;
+	box.y += ly;
+	struct wlr_box extents = ssd_max_extents(view);
+	extend_box(&box, extents.x, extents.y, extents.width, extents.height);
+	return box;
+}
+
+static void
+hit_index_clear(struct hit_index *index)
+{
+	for (size_t i = 0; i < HIT_INDEX_GRID_SIZE * HIT_INDEX_GRID_SIZE; i++) {
+		index->cells[i].size = 0;
+	}
+}
+
+static int
+cell_coord(int offset, int size)
+{
+	int cell = (int64_t)offset * HIT_INDEX_GRID_SIZE / size;
+	return cell < 0 ? 0 : MIN(cell, HIT_INDEX_GRID_SIZE - 1);
+}
+
+static void
+hit_index_add(struct hit_index *index, struct view *view)
+{
+	struct wlr_box *ob = &index->output_box;
+	struct wlr_box intersection;
+	if (!wlr_box_intersection(&intersection, &view->hit_box, ob)) {
+		return;
+	}
+	int x1 = cell_coord(intersection.x - ob->x, ob->width);
+	int y1 = cell_coord(intersection.y - ob->y, ob->height);
+	int x2 = cell_coord(intersection.x + intersection.width - 1 - ob->x,
+		ob->width);
+	int y2 = cell_coord(intersection.y + intersection.height - 1 - ob->y,
+		ob->height);
+	for (int y = y1; y <= y2; y++) {
+		for (int x = x1; x <= x2; x++) {
+			struct wl_array *cell =
+				&index->cells[y * HIT_INDEX_GRID_SIZE + x];
+			struct view **entry = wl_array_add(cell, sizeof(*entry));
+			if (entry) {
+				*entry = view;
+			}
+		}
+	}
+}
+
+static void
+hit_index_remove(struct hit_index *index, struct view *view)
+{
+	struct wlr_box *ob = &index->output_box;
+	struct wlr_box intersection;
+	if (!wlr_box_intersection(&intersection, &view->hit_box, ob)) {
+		return;
+	}
+	int x1 = cell_coord(intersection.x - ob->x, ob->width);
+	int y1 = cell_coord(intersection.y - ob->y, ob->height);
+	int x2 = cell_coord(intersection.x + intersection.width - 1 - ob->x,
+		ob->width);
+	int y2 = cell_coord(intersection.y + intersection.height - 1 - ob->y,
+		ob->height);
+	for (int y = y1; y <= y2; y++) {
+		for (int x = x1; x <= x2; x++) {
+			struct wl_array *cell =
+				&index->cells[y * HIT_INDEX_GRID_SIZE + x];
+			struct view **entries = cell->data;
+			size_t len = cell->size / sizeof(*entries);
+			for (size_t i = 0; i < len; i++) {
+				if (entries[i] == view) {
+					/* Cells are unordered */
+					entries[i] = entries[len - 1];
+					cell->size -= sizeof(*entries);
+					break;
+				}
+			}
+		}
+	}
+}
+
+static void
+rebuild(struct server *server)
+{
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (!output->hit_index) {
+			output->hit_index = znew(*output->hit_index);
+			for (size_t i = 0; i < ARRAY_SIZE(output->hit_index->cells); i++) {
+				wl_array_init(&output->hit_index->cells[i]);
+			}
+		}
+		struct hit_index *index = output->hit_index;
+		hit_index_clear(index);
+		wlr_output_layout_get_box(server->output_layout,
+			output->wlr_output, &index->output_box);
+		if (wlr_box_empty(&index->output_box)) {
+			continue;
+		}
+		struct view *view;
+		wl_list_for_each(view, &server->views, link) {
+			hit_index_add(index, view);
+		}
+	}
+	server->hit_index_dirty = false;
+}
+
+struct wl_array *
+hit_index_query(struct server *server, double lx, double ly)
+{
+	struct wlr_output *wlr_output =
+		wlr_output_layout_output_at(server->output_layout, lx, ly);
+	struct output *output = wlr_output ? wlr_output->data : NULL;
+	if (!output) {
+		return NULL;
+	}
+
+	if (server->hit_index_dirty || !output->hit_index) {
+		struct view *view;
+		wl_list_for_each(view, &server->views, link) {
+			view->hit_box = get_view_box(view);
+		}
+		rebuild(server);
+	}
+
+	struct hit_index *index = output->hit_index;
+	struct wlr_box *ob = &index->output_box;
+	if (wlr_box_empty(ob)) {
+		return NULL;
+	}
+	int x = cell_coord((int)lx - ob->x, ob->width);
+	int y = cell_coord((int)ly - ob->y, ob->height);
+	return &index->cells[y * HIT_INDEX_GRID_SIZE + x];
+}
+
+bool
+hit_index_view_damage(struct view *view)
+{
+	struct server *server = view->server;
+	view->hit_bounds_dirty = true;
+	if (server->hit_index_dirty) {
+		/* All boxes are recomputed by the next query */
+		return true;
+	}
+	struct wlr_box box = get_view_box(view);
+	if (wlr_box_equal(&box, &view->hit_box)) {
+		return false;
+	}
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (output->hit_index) {
+			hit_index_remove(output->hit_index, view);
+		}
+	}
+	view->hit_box = box;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (output->hit_index) {
+			hit_index_add(output->hit_index, view);
+		}
+	}
+	return true;
+}
+
+void
+hit_index_on_view_destroy(struct view *view)
+{
+	/* The grids must not keep pointers to the view */
+	struct output *output;
+	wl_list_for_each(output, &view->server->outputs, link) {
+		if (output->hit_index) {
+			hit_index_remove(output->hit_index, view);
+		}
+	}
+	view->hit_box = (struct wlr_box){0};
+}
+
+void
+hit_index_on_layout_change(struct server *server)
+{
+	server->hit_index_dirty = true;
+}
+
+void
+hit_index_on_output_destroy(struct output *output)
+{
+	if (!output->hit_index) {
+		return;
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(output->hit_index->cells); i++) {
+		wl_array_release(&output->hit_index->cells[i]);
+	}
+	zfree(output->hit_index);
+}
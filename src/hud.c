@@ -0,0 +1,269 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Performance HUD
+ *
+ * The HUD is refreshed from a timer rather than from the frame handler, so
+ * that it does not cause extra frames on otherwise idle outputs. Each line
+ * is a scaled_font_buffer which is only re-rendered if its text changed.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/log.h>
+#include "buffer.h"
+#include "common/graphic-helpers.h"
+#include "common/mem.h"
+#include "common/scene-helpers.h"
+#include "common/scaled_font_buffer.h"
+#include "config/rcxml.h"
+#include "hud.h"
+#include "labwc.h"
+#include "theme.h"
+#include "view.h"
+
+#define HUD_UPDATE_INTERVAL_MS 250
+#define HUD_MARGIN 8
+#define HUD_PADDING 4
+#define HUD_MAX_WIDTH 400
+
+enum hud_line {
+	HUD_LINE_FPS = 0,
+	HUD_LINE_COMMIT,
+	HUD_LINE_BUSY,
+	HUD_LINE_NODES,
+	HUD_LINE_VIEWS,
+	HUD_LINE_COUNT
+};
+
+struct hud {
+	struct wlr_scene_tree *tree;
+	struct wlr_scene_buffer *background;
+	struct scaled_font_buffer *lines[HUD_LINE_COUNT];
+	char text[HUD_LINE_COUNT][64];
+	uint64_t last_nr_presented;
+};
+
+static struct {
+	bool enabled;
+	struct wl_event_source *timer;
+	struct timespec last_update;
+	struct timespec last_cpu_time;
+} hud_state;
+
+static bool
+no_input(struct wlr_scene_buffer *buffer, int sx, int sy)
+{
+	/* The HUD must not hide anything below it from the cursor */
+	return false;
+}
+
+static int
+count_nodes(struct wlr_scene_node *node)
+{
+	int count = 1;
+	if (node->type == WLR_SCENE_NODE_TREE) {
+		struct wlr_scene_tree *tree = lab_scene_tree_from_node(node);
+		struct wlr_scene_node *child;
+		wl_list_for_each(child, &tree->children, link) {
+			count += count_nodes(child);
+		}
+	}
+	return count;
+}
+
+static int
+count_mapped_views(struct server *server)
+{
+	int count = 0;
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (view->mapped) {
+			count++;
+		}
+	}
+	return count;
+}
+
+static int64_t
+timespec_diff_usec(const struct timespec *a, const struct timespec *b)
+{
+	return (int64_t)(b->tv_sec - a->tv_sec) * 1000000
+		+ (b->tv_nsec - a->tv_nsec) / 1000;
+}
+
+static struct wlr_scene_buffer *
+create_background(struct wlr_scene_tree *parent, float *color)
+{
+	struct lab_data_buffer *buffer = buffer_create_cairo(1, 1, 1, true);
+	if (!buffer) {
+		return NULL;
+	}
+	set_cairo_color(buffer->cairo, color);
+	cairo_paint(buffer->cairo);
+	cairo_surface_flush(cairo_get_target(buffer->cairo));
+
+	struct wlr_scene_buffer *scene_buffer =
+		wlr_scene_buffer_create(parent, &buffer->base);
+	wlr_buffer_drop(&buffer->base);
+	if (scene_buffer) {
+		scene_buffer->point_accepts_input = no_input;
+	}
+	return scene_buffer;
+}
+
+static struct hud *
+hud_create(struct output *output)
+{
+	struct server *server = output->server;
+	struct hud *hud = znew(*hud);
+	hud->tree = wlr_scene_tree_create(&server->scene->tree);
+	wlr_scene_node_place_above(&hud->tree->node, &output->osd_tree->node);
+	hud->background = create_background(hud->tree,
+		server->theme->osd_bg_color);
+	for (size_t i = 0; i < HUD_LINE_COUNT; i++) {
+		hud->lines[i] = scaled_font_buffer_create(hud->tree);
+		hud->lines[i]->scene_buffer->point_accepts_input = no_input;
+	}
+	hud->last_nr_presented = output->frame_stats.nr_presented;
+	return hud;
+}
+
+static void
+hud_destroy(struct output *output)
+{
+	if (!output->hud) {
+		return;
+	}
+	/* The font buffers are destroyed along with their scene nodes */
+	wlr_scene_node_destroy(&output->hud->tree->node);
+	zfree(output->hud);
+}
+
+static void
+hud_update_output(struct output *output, double elapsed_sec, int busy_pct,
+		int nr_nodes, int nr_views)
+{
+	struct server *server = output->server;
+	struct hud *hud = output->hud;
+	struct frame_stats *stats = &output->frame_stats;
+
+	char text[HUD_LINE_COUNT][64];
+	double fps = elapsed_sec > 0 ? (stats->nr_presented
+		- hud->last_nr_presented) / elapsed_sec : 0;
+	hud->last_nr_presented = stats->nr_presented;
+	snprintf(text[HUD_LINE_FPS], sizeof(text[0]), "fps: %.1f", fps);
+	snprintf(text[HUD_LINE_COMMIT], sizeof(text[0]), "commit: %.2f ms",
+		histogram_last(&stats->commit_time) / 1000.0);
+	snprintf(text[HUD_LINE_BUSY], sizeof(text[0]), "busy: %d%%",
+		busy_pct);
+	snprintf(text[HUD_LINE_NODES], sizeof(text[0]), "nodes: %d",
+		nr_nodes);
+	snprintf(text[HUD_LINE_VIEWS], sizeof(text[0]), "views: %d",
+		nr_views);
+
+	int y = HUD_PADDING;
+	int width = 0;
+	for (size_t i = 0; i < HUD_LINE_COUNT; i++) {
+		struct scaled_font_buffer *line = hud->lines[i];
+		if (strcmp(text[i], hud->text[i])) {
+			memcpy(hud->text[i], text[i], sizeof(text[i]));
+			scaled_font_buffer_update(line, text[i], HUD_MAX_WIDTH,
+				&rc.font_osd, server->theme->osd_label_text_color,
+				NULL);
+		}
+		wlr_scene_node_set_position(&line->scene_buffer->node,
+			HUD_PADDING, y);
+		y += line->height;
+		if (line->width > width) {
+			width = line->width;
+		}
+	}
+	if (hud->background) {
+		wlr_scene_buffer_set_dest_size(hud->background,
+			width + 2 * HUD_PADDING, y + HUD_PADDING);
+	}
+
+	struct wlr_box output_box;
+	wlr_output_layout_get_box(server->output_layout, output->wlr_output,
+		&output_box);
+	wlr_scene_node_set_position(&hud->tree->node,
+		output_box.x + output->usable_area.x + HUD_MARGIN,
+		output_box.y + output->usable_area.y + HUD_MARGIN);
+}
+
+static int
+handle_timer(void *data)
+{
+	struct server *server = data;
+
+	struct timespec now, cpu_time;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time);
+	int64_t elapsed = timespec_diff_usec(&hud_state.last_update, &now);
+	int64_t busy = timespec_diff_usec(&hud_state.last_cpu_time, &cpu_time);
+	hud_state.last_update = now;
+	hud_state.last_cpu_time = cpu_time;
+
+	/* Everything is done in the main thread, so its CPU time is busy time */
+	int busy_pct = elapsed > 0 ? busy * 100 / elapsed : 0;
+	int nr_nodes = count_nodes(&server->scene->tree.node);
+	int nr_views = count_mapped_views(server);
+
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (!output_is_usable(output)) {
+			hud_destroy(output);
+			continue;
+		}
+		if (!output->hud) {
+			output->hud = hud_create(output);
+		}
+		hud_update_output(output, elapsed / 1e6, busy_pct, nr_nodes,
+			nr_views);
+	}
+
+	wl_event_source_timer_update(hud_state.timer, HUD_UPDATE_INTERVAL_MS);
+	return 0;
+}
+
+void
+hud_toggle(struct server *server)
+{
+	hud_state.enabled = !hud_state.enabled;
+	if (!hud_state.enabled) {
+		struct output *output;
+		wl_list_for_each(output, &server->outputs, link) {
+			hud_destroy(output);
+		}
+		if (hud_state.timer) {
+			wl_event_source_timer_update(hud_state.timer, 0);
+		}
+		return;
+	}
+
+	if (!hud_state.timer) {
+		hud_state.timer = wl_event_loop_add_timer(server->wl_event_loop,
+			handle_timer, server);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &hud_state.last_update);
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &hud_state.last_cpu_time);
+	wl_event_source_timer_update(hud_state.timer, HUD_UPDATE_INTERVAL_MS);
+}
+
+void
+hud_on_output_destroy(struct output *output)
+{
+	hud_destroy(output);
+}
+
+void
+hud_finish(struct server *server)
+{
+	if (hud_state.timer) {
+		wl_event_source_remove(hud_state.timer);
+		hud_state.timer = NULL;
+	}
+	hud_state.enabled = false;
+}
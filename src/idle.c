@@ -2,12 +2,16 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <time.h>
 #include <wlr/types/wlr_idle.h>
 #include <wlr/types/wlr_idle_notify_v1.h>
 #include <wlr/types/wlr_idle_inhibit_v1.h>
 #include "common/mem.h"
 #include "idle.h"
 
+/* Minimum interval between two activity notifications */
+#define ACTIVITY_INTERVAL_MSEC (50)
+
 struct lab_idle_inhibitor {
 	struct wlr_idle_inhibitor_v1 *wlr_inhibitor;
 	struct wl_listener on_destroy;
@@ -22,6 +26,12 @@ struct lab_idle_manager {
 	} inhibitor;
 	struct wlr_seat *wlr_seat;
 	struct wl_listener on_display_destroy;
+	struct {
+		int64_t last_msec;
+		/* Seat with activity not notified yet */
+		struct wlr_seat *pending_seat;
+		struct wl_event_source *timer;
+	} activity;
 };
 
 static struct lab_idle_manager *manager;
@@ -70,9 +80,60 @@ handle_display_destroy(struct wl_listener *listener, void *data)
 	 * destroy signal as well and thus clean up.
 	 */
 	wl_list_remove(&manager->on_display_destroy.link);
+	if (manager->activity.timer) {
+		wl_event_source_remove(manager->activity.timer);
+	}
 	zfree(manager);
 }
 
+static int64_t
+now_msec(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static void
+notify_activity(struct wlr_seat *seat, int64_t now)
+{
+	manager->activity.last_msec = now;
+	manager->activity.pending_seat = NULL;
+	wlr_idle_notify_activity(manager->kde, seat);
+	wlr_idle_notifier_v1_notify_activity(manager->ext, seat);
+}
+
+static int
+handle_activity_timer(void *data)
+{
+	if (manager && manager->activity.pending_seat) {
+		notify_activity(manager->activity.pending_seat, now_msec());
+	}
+	return 0;
+}
+
+/*
+ * Returns true if a KDE idle client of @seat is idle right now or could
+ * become idle before the next coalesced notification. The state of
+ * ext-idle-notify clients is private to wlroots, they are covered by
+ * idle timeouts being far longer than ACTIVITY_INTERVAL_MSEC in practice.
+ */
+static bool
+kde_needs_notify(struct wlr_seat *seat)
+{
+	struct wlr_idle_timeout *timeout;
+	wl_list_for_each(timeout, &manager->kde->idle_timers, link) {
+		if (timeout->seat != seat) {
+			continue;
+		}
+		if (timeout->idle_state
+				|| timeout->timeout < ACTIVITY_INTERVAL_MSEC) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void
 idle_manager_create(struct wl_display *display, struct wlr_seat *wlr_seat)
 {
@@ -90,6 +151,9 @@ idle_manager_create(struct wl_display *display, struct wlr_seat *wlr_seat)
 
 	manager->on_display_destroy.notify = handle_display_destroy;
 	wl_display_add_destroy_listener(display, &manager->on_display_destroy);
+
+	manager->activity.timer = wl_event_loop_add_timer(
+		wl_display_get_event_loop(display), handle_activity_timer, NULL);
 }
 
 void
@@ -105,6 +169,28 @@ idle_manager_notify_activity(struct wlr_seat *seat)
 		return;
 	}
 
-	wlr_idle_notify_activity(manager->kde, seat);
-	wlr_idle_notifier_v1_notify_activity(manager->ext, seat);
+	/*
+	 * This is called for every input event, which means up to
+	 * several thousand times per second for high polling rate
+	 * mice. Each notification resets the timers of all idle
+	 * clients, so only notify once per ACTIVITY_INTERVAL_MSEC
+	 * and catch up on the remaining activity from a timer.
+	 * Resuming from idle is still notified right away.
+	 */
+	int64_t now = now_msec();
+	int64_t elapsed = now - manager->activity.last_msec;
+	if (elapsed >= ACTIVITY_INTERVAL_MSEC || !manager->activity.timer
+			|| kde_needs_notify(seat)) {
+		if (manager->activity.pending_seat) {
+			wl_event_source_timer_update(manager->activity.timer, 0);
+		}
+		notify_activity(seat, now);
+		return;
+	}
+
+	if (!manager->activity.pending_seat) {
+		manager->activity.pending_seat = seat;
+		wl_event_source_timer_update(manager->activity.timer,
+			ACTIVITY_INTERVAL_MSEC - elapsed);
+	}
 }
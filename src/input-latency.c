@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include "common/array-size.h"
+#include "frame-stats.h"
+#include "input-latency.h"
+#include "labwc.h"
+
+/* Event timestamps too far in the past are from a different clock */
+#define MAX_EVENT_DELAY_MSEC (10000)
+
+/* Used if the refresh rate of the output is unknown */
+#define DEFAULT_FRAME_PERIOD_USEC (16667)
+
+/* Upper bounds of the histogram buckets in usec */
+static const uint32_t time_bounds[] = {
+	500, 1000, 2000, 4000, 8000, 16667, 33333, 50000, 100000
+};
+/* Event timestamps only have millisecond resolution */
+static const uint32_t event_bounds[] = {
+	1000, 2000, 4000, 8000, 16000, 33000, 50000, 100000
+};
+
+/*
+ * An event which has not caused a frame on its output within two refresh
+ * cycles did not damage anything. It is dropped so that the latency of a
+ * later event is not measured from its dispatch.
+ */
+static bool
+caused_no_frame(struct input_latency *latency, const struct timespec *now)
+{
+	struct output *output = latency->pending_output;
+	if (!output) {
+		return true;
+	}
+	if (frame_stats_timespec_diff_usec(&latency->pending_dispatch,
+			&output->frame_stats.last_commit)) {
+		/* Waiting for presentation */
+		return false;
+	}
+	int refresh = output->wlr_output->refresh;
+	uint32_t period = refresh > 0 ? 1000000000 / refresh
+		: DEFAULT_FRAME_PERIOD_USEC;
+	return frame_stats_timespec_diff_usec(&latency->pending_dispatch, now)
+		> 2 * period;
+}
+
+void
+input_latency_record_event(struct input_latency *latency, uint32_t time_msec,
+		struct output *output)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	/*
+	 * libinput timestamps are CLOCK_MONOTONIC in msec, truncated to
+	 * 32 bits. Compare them with the current time truncated the same
+	 * way so that wrap-around does not matter. As both are truncated to
+	 * whole milliseconds, the delay is only accurate to +/- 1 msec.
+	 */
+	uint32_t now_msec = (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+	uint32_t delay_msec = now_msec - time_msec;
+	if (delay_msec <= MAX_EVENT_DELAY_MSEC) {
+		histogram_add(&latency->event_to_dispatch, delay_msec * 1000);
+	}
+
+	if (latency->pending && caused_no_frame(latency, &now)) {
+		latency->pending = false;
+	}
+	if (!latency->pending && output) {
+		latency->pending_dispatch = now;
+		latency->pending_output = output;
+		latency->pending = true;
+	}
+}
+
+void
+input_latency_record_present(struct input_latency *latency,
+		struct output *output, const struct timespec *commit,
+		const struct timespec *when)
+{
+	if (!latency->pending || output != latency->pending_output) {
+		return;
+	}
+	/* Frames committed before the dispatch cannot show the change */
+	if (!frame_stats_timespec_diff_usec(&latency->pending_dispatch,
+			commit)) {
+		return;
+	}
+	histogram_add(&latency->dispatch_to_present,
+		frame_stats_timespec_diff_usec(&latency->pending_dispatch, when));
+	latency->pending = false;
+}
+
+void
+input_latency_on_output_destroy(struct input_latency *latency,
+		struct output *output)
+{
+	if (latency->pending_output == output) {
+		latency->pending_output = NULL;
+		latency->pending = false;
+	}
+}
+
+void
+input_latency_print(struct input_latency *latency, FILE *stream,
+		const char *name)
+{
+	char prefix[256];
+
+	snprintf(prefix, sizeof(prefix), "%s event_to_dispatch_us", name);
+	histogram_print(&latency->event_to_dispatch, stream, prefix,
+		event_bounds, ARRAY_SIZE(event_bounds));
+	snprintf(prefix, sizeof(prefix), "%s dispatch_to_present_us", name);
+	histogram_print(&latency->dispatch_to_present, stream, prefix,
+		time_bounds, ARRAY_SIZE(time_bounds));
+}
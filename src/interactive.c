@@ -2,6 +2,7 @@
 #include "labwc.h"
 #include "regions.h"
 #include "resize_indicator.h"
+#include "resize-snapshot.h"
 #include "view.h"
 
 static int
@@ -100,6 +101,9 @@ interactive_begin(struct view *view, enum input_mode mode, uint32_t edges)
 	if (rc.resize_indicator) {
 		resize_indicator_show(view);
 	}
+	if (mode == LAB_INPUT_STATE_RESIZE) {
+		resize_snapshot_begin(view);
+	}
 }
 
 /* Returns true if view was snapped to any edge */
@@ -167,6 +171,8 @@ void
 interactive_finish(struct view *view)
 {
 	if (view->server->grabbed_view == view) {
+		/* Must be called before the input mode is reset */
+		resize_snapshot_end(view);
 		regions_hide_overlay(&view->server->seat);
 		if (view->server->input_mode == LAB_INPUT_STATE_MOVE) {
 			if (!snap_to_region(view)) {
@@ -195,6 +201,7 @@ void
 interactive_cancel(struct view *view)
 {
 	if (view->server->grabbed_view == view) {
+		resize_snapshot_end(view);
 		resize_indicator_hide(view);
 		view->server->input_mode = LAB_INPUT_STATE_PASSTHROUGH;
 		view->server->grabbed_view = NULL;
@@ -88,37 +88,16 @@ keyboard_modifiers_notify(struct wl_listener *listener, void *data)
 static bool
 handle_keybinding(struct server *server, uint32_t modifiers, xkb_keysym_t sym, xkb_keycode_t code)
 {
-	struct keybind *keybind;
-	wl_list_for_each(keybind, &rc.keybinds, link) {
-		if (modifiers ^ keybind->modifiers) {
-			continue;
-		}
-		if (server->seat.nr_inhibited_keybind_views
-				&& view_inhibits_keybinds(desktop_focused_view(server))
-				&& !actions_contain_toggle_keybinds(&keybind->actions)) {
-			continue;
-		}
-		if (sym == XKB_KEY_NoSymbol) {
-			/* Use keycodes */
-			for (size_t i = 0; i < keybind->keycodes_len; i++) {
-				if (keybind->keycodes[i] == code) {
-					key_state_store_pressed_keys_as_bound();
-					actions_run(NULL, server, &keybind->actions, 0);
-					return true;
-				}
-			}
-		} else {
-			/* Use syms */
-			for (size_t i = 0; i < keybind->keysyms_len; i++) {
-				if (xkb_keysym_to_lower(sym) == keybind->keysyms[i]) {
-					key_state_store_pressed_keys_as_bound();
-					actions_run(NULL, server, &keybind->actions, 0);
-					return true;
-				}
-			}
-		}
+	bool toggle_only = server->seat.nr_inhibited_keybind_views
+		&& view_inhibits_keybinds(desktop_focused_view(server));
+	struct keybind *keybind =
+		keybind_lookup(modifiers, sym, code, toggle_only);
+	if (!keybind) {
+		return false;
 	}
-	return false;
+	key_state_store_pressed_keys_as_bound();
+	actions_run(NULL, server, &keybind->actions, 0);
+	return true;
 }
 
 static bool is_modifier_key(xkb_keysym_t sym)
@@ -434,6 +413,8 @@ keyboard_key_notify(struct wl_listener *listener, void *data)
 	struct wlr_seat *wlr_seat = seat->seat;
 	struct wlr_keyboard *wlr_keyboard = keyboard->wlr_keyboard;
 	idle_manager_notify_activity(seat->seat);
+	seat_record_input_event(seat, keyboard->base.wlr_input_device,
+		event->time_msec);
 
 	/* any new press/release cancels current keybind repeat */
 	keyboard_cancel_keybind_repeat(keyboard);
@@ -160,6 +160,8 @@ handle_surface_commit(struct wl_listener *listener, void *data)
 	if (!wlr_output) {
 		return;
 	}
+	/* The surface may have been resized even if no state was committed */
+	layer->server->scene_generation++;
 
 	uint32_t committed = layer_surface->current.committed;
 	struct output *output = (struct output *)wlr_output->data;
@@ -197,6 +199,7 @@ handle_node_destroy(struct wl_listener *listener, void *data)
 	 * focus to.
 	 */
 
+	layer->server->scene_generation++;
 	wl_list_remove(&layer->map.link);
 	wl_list_remove(&layer->unmap.link);
 	wl_list_remove(&layer->surface_commit.link);
@@ -212,6 +215,7 @@ handle_unmap(struct wl_listener *listener, void *data)
 	struct lab_layer_surface *layer = wl_container_of(listener, layer, unmap);
 	struct wlr_layer_surface_v1 *layer_surface =
 		layer->scene_layer_surface->layer_surface;
+	layer->server->scene_generation++;
 	if (layer_surface->output) {
 		output_update_usable_area(layer_surface->output->data);
 	}
@@ -227,6 +231,7 @@ handle_map(struct wl_listener *listener, void *data)
 	struct lab_layer_surface *layer = wl_container_of(listener, layer, map);
 	struct wlr_output *wlr_output =
 		layer->scene_layer_surface->layer_surface->output;
+	layer->server->scene_generation++;
 	if (wlr_output) {
 		output_update_usable_area(wlr_output->data);
 	}
@@ -352,6 +357,7 @@ handle_new_popup(struct wl_listener *listener, void *data)
 			== ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM) {
 		move_popup_to_top_layer(toplevel, popup);
 	}
+	server->scene_generation++;
 }
 
 static void
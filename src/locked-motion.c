@@ -0,0 +1,21 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include <wlr/types/wlr_pointer.h>
+#include <wlr/types/wlr_relative_pointer_v1.h>
+#include "idle.h"
+#include "labwc.h"
+#include "locked-motion.h"
+
+/*
+ * Fast path for pointers locked by the focused client, typically games
+ * consuming relative motion at polling rates of 1000 Hz and more.
+ */
+void
+locked_motion_notify(struct seat *seat, struct wlr_pointer_motion_event *event)
+{
+	idle_manager_notify_activity(seat->seat);
+	wlr_relative_pointer_manager_v1_send_relative_motion(
+		seat->server->relative_pointer_manager,
+		seat->seat, (uint64_t)event->time_msec * 1000,
+		event->delta_x, event->delta_y, event->unaccel_dx,
+		event->unaccel_dy);
+}
@@ -797,6 +797,7 @@ menu_set_selection(struct menu *menu, struct menuitem *item)
 		wlr_scene_node_set_enabled(&item->selected.tree->node, true);
 	}
 	menu->selection.item = item;
+	menu->server->scene_generation++;
 }
 
 static void
@@ -839,6 +840,7 @@ menu_open(struct menu *menu, int x, int y)
 	menu_set_selection(menu, NULL);
 	menu_configure(menu, x, y, LAB_MENU_OPEN_AUTO);
 	wlr_scene_node_set_enabled(&menu->scene_tree->node, true);
+	menu->server->scene_generation++;
 	menu->server->menu_current = menu;
 	menu->server->input_mode = LAB_INPUT_STATE_MENU;
 }
@@ -867,6 +869,7 @@ menu_process_item_selection(struct menuitem *item)
 		/* And open the new submenu tree */
 		wlr_scene_node_set_enabled(
 			&item->submenu->scene_tree->node, true);
+		item->parent->server->scene_generation++;
 	}
 	item->parent->selection.menu = item->submenu;
 }
@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Output mirroring
+ *
+ * A mirror target is not part of the output layout and therefore does not
+ * composite the scene itself. Instead, the buffer last committed on the
+ * source output is kept and drawn onto the target as a single texture.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <strings.h>
+#include <wlr/render/wlr_renderer.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_matrix.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/util/box.h>
+#include <wlr/util/log.h>
+#include "common/mem.h"
+#include "config/rcxml.h"
+#include "labwc.h"
+#include "mirror.h"
+
+static const char *
+get_mirror_source_name(const char *name)
+{
+	const char *source = NULL;
+	struct output_config *config;
+	wl_list_for_each(config, &rc.output_configs, link) {
+		if (config->name && strcasecmp(config->name, name)) {
+			continue;
+		}
+		if (config->mirror) {
+			source = config->mirror;
+		}
+	}
+	return source;
+}
+
+static bool
+is_mirror_of(struct output *target, struct output *source)
+{
+	return target != source && target->mirror_of
+		&& !strcasecmp(target->mirror_of, source->wlr_output->name);
+}
+
+/* Mirroring a mirror target is not supported, so it is never a source */
+static struct output *
+get_source(struct output *target)
+{
+	struct output *output;
+	wl_list_for_each(output, &target->server->outputs, link) {
+		if (!output->mirror_of && is_mirror_of(target, output)) {
+			return output;
+		}
+	}
+	return NULL;
+}
+
+static void
+schedule_targets(struct output *source)
+{
+	struct output *output;
+	wl_list_for_each(output, &source->server->outputs, link) {
+		if (is_mirror_of(output, source)) {
+			output->mirror_needs_frame = true;
+			wlr_output_schedule_frame(output->wlr_output);
+		}
+	}
+}
+
+void
+mirror_init(struct output *output)
+{
+	const char *source = get_mirror_source_name(output->wlr_output->name);
+	if (!source || !strcasecmp(source, output->wlr_output->name)) {
+		return;
+	}
+	wlr_log(WLR_INFO, "output %s mirrors %s", output->wlr_output->name,
+		source);
+	output->mirror_of = xstrdup(source);
+	output->mirror_needs_frame = true;
+}
+
+void
+mirror_handle_commit(struct output *output,
+		struct wlr_output_event_commit *event)
+{
+	if (output->mirror_of || !(event->committed & WLR_OUTPUT_STATE_BUFFER)
+			|| !event->buffer) {
+		return;
+	}
+
+	bool mirrored = false;
+	struct output *target;
+	wl_list_for_each(target, &output->server->outputs, link) {
+		if (is_mirror_of(target, output)) {
+			mirrored = true;
+			break;
+		}
+	}
+
+	if (output->mirror_buffer) {
+		wlr_buffer_unlock(output->mirror_buffer);
+		output->mirror_buffer = NULL;
+	}
+	if (mirrored) {
+		output->mirror_buffer = wlr_buffer_lock(event->buffer);
+		schedule_targets(output);
+	}
+}
+
+/* Largest box with the aspect ratio of source centered in width x height */
+static struct wlr_box
+get_letterbox(struct wlr_output *source, int width, int height)
+{
+	int source_width, source_height;
+	wlr_output_transformed_resolution(source, &source_width,
+		&source_height);
+	struct wlr_box box = { .width = width, .height = height };
+	if (source_width <= 0 || source_height <= 0) {
+		return box;
+	}
+	if ((int64_t)width * source_height > (int64_t)height * source_width) {
+		box.width = (int64_t)height * source_width / source_height;
+	} else {
+		box.height = (int64_t)width * source_height / source_width;
+	}
+	box.x = (width - box.width) / 2;
+	box.y = (height - box.height) / 2;
+	return box;
+}
+
+void
+mirror_render(struct output *output)
+{
+	struct wlr_output *wlr_output = output->wlr_output;
+	if (!output->mirror_needs_frame || !wlr_output->enabled
+			|| output->leased) {
+		return;
+	}
+	output->mirror_needs_frame = false;
+
+	struct wlr_renderer *renderer = output->server->renderer;
+	struct output *source = get_source(output);
+	struct wlr_texture *texture = NULL;
+	if (source && source->mirror_buffer) {
+		texture = wlr_texture_from_buffer(renderer,
+			source->mirror_buffer);
+	}
+
+	if (!wlr_output_attach_render(wlr_output, NULL)) {
+		wlr_log(WLR_ERROR, "cannot render mirror on output %s",
+			wlr_output->name);
+		goto out;
+	}
+
+	int width, height;
+	wlr_output_transformed_resolution(wlr_output, &width, &height);
+	wlr_renderer_begin(renderer, wlr_output->width, wlr_output->height);
+	wlr_renderer_clear(renderer, (float[4]){ 0.0f, 0.0f, 0.0f, 1.0f });
+	if (texture) {
+		/*
+		 * The source buffer has the transform of the source output
+		 * applied already, so invert it to get the content upright.
+		 */
+		struct wlr_box box = get_letterbox(source->wlr_output,
+			width, height);
+		enum wl_output_transform transform =
+			wlr_output_transform_invert(source->wlr_output->transform);
+		float matrix[9];
+		wlr_matrix_project_box(matrix, &box, transform, 0,
+			wlr_output->transform_matrix);
+		wlr_render_texture_with_matrix(renderer, texture, matrix, 1.0f);
+	}
+	wlr_renderer_end(renderer);
+
+	if (!wlr_output_commit(wlr_output)) {
+		wlr_log(WLR_DEBUG, "mirror commit failed on output %s",
+			wlr_output->name);
+	}
+out:
+	if (texture) {
+		wlr_texture_destroy(texture);
+	}
+}
+
+void
+mirror_on_output_destroy(struct output *output)
+{
+	if (output->mirror_buffer) {
+		wlr_buffer_unlock(output->mirror_buffer);
+		output->mirror_buffer = NULL;
+		/* Clear the targets rather than showing a stale frame */
+		schedule_targets(output);
+	}
+	zfree(output->mirror_of);
+}
@@ -0,0 +1,268 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wayland-util.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/util/log.h>
+#include "common/mem.h"
+#include "common/string-helpers.h"
+#include "mode-cache.h"
+
+struct mode_cache_entry {
+	char *make;
+	char *model;
+	char *serial;
+	int32_t width, height, refresh;
+	struct wl_list link;
+};
+
+static struct wl_list entries;
+static bool loaded;
+
+static char *
+state_dir(void)
+{
+	const char *state_home = getenv("XDG_STATE_HOME");
+	if (state_home && *state_home) {
+		return strdup_printf("%s/labwc", state_home);
+	}
+	const char *home = getenv("HOME");
+	if (home && *home) {
+		return strdup_printf("%s/.local/state/labwc", home);
+	}
+	return NULL;
+}
+
+static char *
+cache_path(void)
+{
+	char *dir = state_dir();
+	if (!dir) {
+		return NULL;
+	}
+	char *path = strdup_printf("%s/output-modes", dir);
+	free(dir);
+	return path;
+}
+
+/* Create @path including missing parent directories */
+static bool
+make_dirs(char *path)
+{
+	for (char *p = path + 1; *p; p++) {
+		if (*p != '/') {
+			continue;
+		}
+		*p = '\0';
+		int ret = mkdir(path, 0755);
+		*p = '/';
+		if (ret < 0 && errno != EEXIST) {
+			return false;
+		}
+	}
+	return !mkdir(path, 0755) || errno == EEXIST;
+}
+
+static void
+entry_destroy(struct mode_cache_entry *entry)
+{
+	wl_list_remove(&entry->link);
+	free(entry->make);
+	free(entry->model);
+	free(entry->serial);
+	free(entry);
+}
+
+/*
+ * Each line holds one output as tab separated fields, because make and
+ * model commonly contain spaces:
+ *   <make>\t<model>\t<serial>\t<width>x<height>@<refresh in mHz>
+ */
+static void
+parse_line(char *line)
+{
+	/* Fields may be empty, so strtok_r() cannot be used here */
+	char *fields[4];
+	char *s = line;
+	for (int i = 0; i < 4; i++) {
+		fields[i] = s;
+		s = strchr(s, i < 3 ? '\t' : '\n');
+		if (s) {
+			*s++ = '\0';
+		} else if (i < 3) {
+			return;
+		}
+	}
+
+	int32_t width, height, refresh;
+	if (sscanf(fields[3], "%dx%d@%d", &width, &height, &refresh) != 3) {
+		return;
+	}
+	struct mode_cache_entry *entry = znew(*entry);
+	entry->make = xstrdup(fields[0]);
+	entry->model = xstrdup(fields[1]);
+	entry->serial = xstrdup(fields[2]);
+	entry->width = width;
+	entry->height = height;
+	entry->refresh = refresh;
+	wl_list_insert(entries.prev, &entry->link);
+}
+
+static void
+load(void)
+{
+	if (loaded) {
+		return;
+	}
+	loaded = true;
+	wl_list_init(&entries);
+
+	char *path = cache_path();
+	if (!path) {
+		return;
+	}
+	FILE *stream = fopen(path, "r");
+	free(path);
+	if (!stream) {
+		return;
+	}
+	char *line = NULL;
+	size_t len = 0;
+	while (getline(&line, &len, stream) != -1) {
+		parse_line(line);
+	}
+	free(line);
+	fclose(stream);
+}
+
+static void
+save(void)
+{
+	char *dir = state_dir();
+	char *path = cache_path();
+	char *tmp_path = path ? strdup_printf("%s.tmp", path) : NULL;
+	if (!dir || !tmp_path) {
+		goto out;
+	}
+	if (!make_dirs(dir)) {
+		wlr_log_errno(WLR_ERROR, "cannot create '%s'", dir);
+		goto out;
+	}
+	FILE *stream = fopen(tmp_path, "w");
+	if (!stream) {
+		wlr_log_errno(WLR_ERROR, "cannot write '%s'", tmp_path);
+		goto out;
+	}
+	struct mode_cache_entry *entry;
+	wl_list_for_each(entry, &entries, link) {
+		fprintf(stream, "%s\t%s\t%s\t%dx%d@%d\n", entry->make,
+			entry->model, entry->serial, entry->width,
+			entry->height, entry->refresh);
+	}
+	fclose(stream);
+	if (rename(tmp_path, path) < 0) {
+		wlr_log_errno(WLR_ERROR, "cannot rename '%s'", tmp_path);
+		unlink(tmp_path);
+	}
+out:
+	free(tmp_path);
+	free(path);
+	free(dir);
+}
+
+/* Tabs and newlines would break the line based file format */
+static bool
+is_valid_field(const char *s)
+{
+	return !strpbrk(s, "\t\n");
+}
+
+static struct mode_cache_entry *
+find_entry(struct wlr_output *wlr_output)
+{
+	load();
+	struct mode_cache_entry *entry;
+	wl_list_for_each(entry, &entries, link) {
+		if (!strcmp(entry->make, wlr_output->make)
+				&& !strcmp(entry->model, wlr_output->model)
+				&& !strcmp(entry->serial, wlr_output->serial)) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+struct wlr_output_mode *
+mode_cache_lookup(struct wlr_output *wlr_output)
+{
+	struct mode_cache_entry *entry = find_entry(wlr_output);
+	if (!entry) {
+		return NULL;
+	}
+	struct wlr_output_mode *mode;
+	wl_list_for_each(mode, &wlr_output->modes, link) {
+		if (mode->width == entry->width && mode->height == entry->height
+				&& mode->refresh == entry->refresh) {
+			return mode;
+		}
+	}
+	return NULL;
+}
+
+void
+mode_cache_store(struct wlr_output *wlr_output)
+{
+	struct wlr_output_mode *mode = wlr_output->current_mode;
+	if (!wlr_output->enabled || !mode) {
+		return;
+	}
+	/* Without any identification all outputs would share one entry */
+	if (!*wlr_output->make && !*wlr_output->model
+			&& !*wlr_output->serial) {
+		return;
+	}
+	if (!is_valid_field(wlr_output->make)
+			|| !is_valid_field(wlr_output->model)
+			|| !is_valid_field(wlr_output->serial)) {
+		return;
+	}
+
+	struct mode_cache_entry *entry = find_entry(wlr_output);
+	if (entry && entry->width == mode->width
+			&& entry->height == mode->height
+			&& entry->refresh == mode->refresh) {
+		return;
+	}
+	if (!entry) {
+		entry = znew(*entry);
+		entry->make = xstrdup(wlr_output->make);
+		entry->model = xstrdup(wlr_output->model);
+		entry->serial = xstrdup(wlr_output->serial);
+		wl_list_insert(entries.prev, &entry->link);
+	}
+	entry->width = mode->width;
+	entry->height = mode->height;
+	entry->refresh = mode->refresh;
+	wlr_log(WLR_DEBUG, "cache mode %dx%d@%d for output %s",
+		mode->width, mode->height, mode->refresh, wlr_output->name);
+	save();
+}
+
+void
+mode_cache_finish(void)
+{
+	if (!loaded) {
+		return;
+	}
+	struct mode_cache_entry *entry, *tmp;
+	wl_list_for_each_safe(entry, tmp, &entries, link) {
+		entry_destroy(entry);
+	}
+	loaded = false;
+}
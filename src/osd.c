@@ -86,6 +86,7 @@ osd_update_preview_outlines(struct view *view)
 	struct wlr_box geo = ssd_max_extents(view);
 	multi_rect_set_size(rect, geo.width, geo.height);
 	wlr_scene_node_set_position(&rect->tree->node, geo.x, geo.y);
+	server->scene_generation++;
 }
 
 void
@@ -154,11 +155,13 @@ osd_finish(struct server *server)
 	}
 
 	/* Hiding OSD may need a cursor change */
+	server->scene_generation++;
 	cursor_update_focus(server);
+	cursor_flush_focus(server);
 
 	/*
-	 * We delay resetting cycle_view until after cursor_update_focus()
-	 * has been called to allow A-Tab keyboard focus switching even if
+	 * We delay resetting cycle_view until after the focus update above
+	 * has been resolved to allow A-Tab keyboard focus switching even if
 	 * followMouse has been configured and the cursor is on a different
 	 * surface. Otherwise cursor_update_focus() would automatically
 	 * refocus the surface the cursor is currently on.
@@ -185,6 +188,7 @@ osd_preview_restore(struct server *server)
 		}
 		osd_state->preview_node = NULL;
 		osd_state->preview_anchor = NULL;
+		server->scene_generation++;
 	}
 }
 
@@ -216,6 +220,7 @@ preview_cycled_view(struct view *view)
 
 	/* Finally raise selected node to the top */
 	wlr_scene_node_raise_to_top(osd_state->preview_node);
+	view->server->scene_generation++;
 }
 
 static const char *
@@ -452,6 +457,7 @@ display_osd(struct output *output)
 	wlr_scene_node_set_enabled(&output->osd_tree->node, true);
 
 	/* Update cursor, in case it is within the area covered by OSD */
+	server->scene_generation++;
 	cursor_update_focus(server);
 }
 
@@ -18,36 +18,216 @@
 #include <wlr/util/log.h>
 #include "common/array-size.h"
 #include "common/mem.h"
+#include "cursor-cache.h"
+#include "fullscreen.h"
+#include "hit-index.h"
+#include "hud.h"
 #include "labwc.h"
 #include "layers.h"
+#include "mirror.h"
+#include "mode-cache.h"
 #include "node.h"
 #include "regions.h"
 #include "view.h"
+#include "visibility.h"
+
+/* Added to the measured commit time when maxRenderTime is "auto" */
+#define AUTO_RENDER_TIME_MARGIN_MS 1
+/* Number of commits between recalculations of the automatic render time */
+#define AUTO_RENDER_TIME_INTERVAL 32
+/* Time to wait for further hotplug events before updating the layout */
+#define OUTPUT_LAYOUT_CHANGE_DELAY_MS 50
+
+static void
+output_commit_frame(struct output *output)
+{
+	fullscreen_update_output(output);
+
+	struct timespec start = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	uint32_t commit_seq = output->wlr_output->commit_seq;
+
+	wlr_scene_output_commit(output->scene_output);
+
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	/* Nothing is committed if there was no damage */
+	if (output->wlr_output->commit_seq != commit_seq) {
+		frame_stats_record_commit(&output->frame_stats, &start, &now);
+	}
+	visibility_send_frame_done(output, &now);
+}
+
+static int
+auto_render_time(struct output *output)
+{
+	struct frame_stats *stats = &output->frame_stats;
+
+	/* Wait for enough samples to get a meaningful estimate */
+	if (stats->commit_time.len < HISTOGRAM_WINDOW / 4) {
+		return LAB_RENDER_TIME_OFF;
+	}
+	if (!output->auto_render_time || stats->nr_commits
+			- output->auto_render_time_commits
+			>= AUTO_RENDER_TIME_INTERVAL) {
+		uint32_t usec = histogram_percentile(&stats->commit_time, 99);
+		output->auto_render_time = usec / 1000 + 1
+			+ AUTO_RENDER_TIME_MARGIN_MS;
+		output->auto_render_time_commits = stats->nr_commits;
+	}
+	return output->auto_render_time;
+}
+
+static int
+max_render_time(struct output *output)
+{
+	int max_render_time = LAB_RENDER_TIME_OFF;
+	struct output_config *config;
+	wl_list_for_each(config, &rc.output_configs, link) {
+		if (config->name && strcasecmp(config->name,
+				output->wlr_output->name)) {
+			continue;
+		}
+		if (config->max_render_time != LAB_RENDER_TIME_UNSET) {
+			max_render_time = config->max_render_time;
+		}
+	}
+	if (max_render_time == LAB_RENDER_TIME_AUTO) {
+		return auto_render_time(output);
+	}
+	return max_render_time;
+}
+
+/*
+ * Returns the number of milliseconds that rendering can be deferred so that
+ * it still completes before the next vblank. The next vblank is predicted
+ * from the last presentation time and the refresh rate.
+ */
+static int
+render_delay(struct output *output)
+{
+	int render_time = max_render_time(output);
+	if (render_time <= 0 || output->wlr_output->refresh <= 0) {
+		return 0;
+	}
+
+	/* wlr_output->refresh is in mHz */
+	int64_t refresh_nsec = 1000000000000LL / output->wlr_output->refresh;
+	struct timespec *last = &output->frame_stats.last_present;
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	int64_t nsec_until_refresh = (last->tv_sec - now.tv_sec) * 1000000000LL
+		+ (last->tv_nsec - now.tv_nsec) + refresh_nsec;
+	if (nsec_until_refresh <= 0) {
+		/* No recent presentation, so there is no point in waiting */
+		return 0;
+	}
+	int delay = nsec_until_refresh / 1000000 - render_time;
+	return delay > 0 ? delay : 0;
+}
+
+static int
+handle_render_timer(void *data)
+{
+	struct output *output = data;
+	if (output_is_usable(output)) {
+		output_commit_frame(output);
+	}
+	return 0;
+}
 
 static void
 output_frame_notify(struct wl_listener *listener, void *data)
 {
 	struct output *output = wl_container_of(listener, output, frame);
+	if (output->mirror_of) {
+		mirror_render(output);
+		return;
+	}
 	if (!output_is_usable(output)) {
 		return;
 	}
 
-	wlr_scene_output_commit(output->scene_output);
+	int delay = render_delay(output);
+	if (delay > 0) {
+		wl_event_source_timer_update(output->render_timer, delay);
+		return;
+	}
+	output_commit_frame(output);
+}
 
-	struct timespec now = { 0 };
-	clock_gettime(CLOCK_MONOTONIC, &now);
-	wlr_scene_output_send_frame_done(output->scene_output, &now);
+static void
+output_present_notify(struct wl_listener *listener, void *data)
+{
+	struct output *output = wl_container_of(listener, output, present);
+	struct wlr_output_event_present *event = data;
+	if (event->presented && output->frame_stats.commit_pending) {
+		seat_record_present(&output->server->seat, output,
+			&output->frame_stats.last_commit, event->when);
+	}
+	frame_stats_record_present(&output->frame_stats, event);
+}
+
+struct scanout_data {
+	struct wlr_buffer *buffer;
+	bool found;
+};
+
+static void
+find_scene_buffer_iterator(struct wlr_scene_buffer *scene_buffer,
+		int sx, int sy, void *user_data)
+{
+	struct scanout_data *data = user_data;
+	if (scene_buffer->buffer == data->buffer) {
+		data->found = true;
+	}
+}
+
+/*
+ * A committed buffer that belongs to a scene node (rather than to the
+ * output's swapchain) means that the scene was scanned out directly.
+ */
+static void
+output_commit_notify(struct wl_listener *listener, void *data)
+{
+	struct output *output = wl_container_of(listener, output, commit);
+	struct wlr_output_event_commit *event = data;
+	mirror_handle_commit(output, event);
+
+	if (!(event->committed & WLR_OUTPUT_STATE_BUFFER) || !event->buffer
+			|| !output->scene_output) {
+		return;
+	}
+	struct scanout_data scanout_data = { .buffer = event->buffer };
+	wlr_scene_output_for_each_buffer(output->scene_output,
+		find_scene_buffer_iterator, &scanout_data);
+	if (scanout_data.found) {
+		output->frame_stats.nr_scanout++;
+	} else {
+		output->frame_stats.nr_composited++;
+	}
 }
 
 static void
 output_destroy_notify(struct wl_listener *listener, void *data)
 {
 	struct output *output = wl_container_of(listener, output, destroy);
+	fullscreen_on_output_destroy(output);
+	mirror_on_output_destroy(output);
+	hud_on_output_destroy(output);
+	hit_index_on_output_destroy(output);
+	seat_on_output_destroy(&output->server->seat, output);
+	output->server->scene_generation++;
+	visibility_arm_fallback(output->server);
 	regions_evacuate_output(output);
 	regions_destroy(&output->server->seat, &output->regions);
 	wl_list_remove(&output->link);
 	wl_list_remove(&output->frame.link);
+	wl_list_remove(&output->present.link);
+	wl_list_remove(&output->commit.link);
 	wl_list_remove(&output->destroy.link);
+	wl_event_source_remove(output->render_timer);
 
 	for (size_t i = 0; i < ARRAY_SIZE(output->layer_tree); i++) {
 		wlr_scene_node_destroy(&output->layer_tree[i]->node);
@@ -123,14 +303,27 @@ new_output_notify(struct wl_listener *listener, void *data)
 
 	/*
 	 * Try to re-use the existing mode if configured to do so.
-	 * Failing that, try to set the preferred mode.
+	 * Failing that, try the last mode known to work for this output
+	 * and then the preferred mode.
 	 */
 	struct wlr_output_mode *preferred_mode = NULL;
+	struct wlr_output_mode *cached_mode = NULL;
 	if (!rc.reuse_output_mode || !can_reuse_mode(wlr_output)) {
-		wlr_log(WLR_DEBUG, "set preferred mode");
-		/* The mode is a tuple of (width, height, refresh rate). */
-		preferred_mode = wlr_output_preferred_mode(wlr_output);
-		wlr_output_set_mode(wlr_output, preferred_mode);
+		cached_mode = mode_cache_lookup(wlr_output);
+		if (cached_mode) {
+			wlr_log(WLR_DEBUG, "set cached mode");
+			wlr_output_set_mode(wlr_output, cached_mode);
+			if (!wlr_output_test(wlr_output)) {
+				wlr_log(WLR_DEBUG, "cached mode rejected");
+				cached_mode = NULL;
+			}
+		}
+		if (!cached_mode) {
+			wlr_log(WLR_DEBUG, "set preferred mode");
+			/* The mode is a tuple of (width, height, refresh rate). */
+			preferred_mode = wlr_output_preferred_mode(wlr_output);
+			wlr_output_set_mode(wlr_output, preferred_mode);
+		}
 	}
 
 	/*
@@ -139,7 +332,7 @@ new_output_notify(struct wl_listener *listener, void *data)
 	 * cases it's better to fallback to lower modes than to end up with
 	 * a black screen. See sway@4cdc4ac6
 	 */
-	if (!wlr_output_test(wlr_output)) {
+	if (!cached_mode && !wlr_output_test(wlr_output)) {
 		wlr_log(WLR_DEBUG,
 			"preferred mode rejected, falling back to another mode");
 		struct wlr_output_mode *mode;
@@ -165,7 +358,9 @@ new_output_notify(struct wl_listener *listener, void *data)
 		}
 	}
 
-	wlr_output_commit(wlr_output);
+	if (wlr_output_commit(wlr_output)) {
+		mode_cache_store(wlr_output);
+	}
 
 	struct output *output = znew(*output);
 	output->wlr_output = wlr_output;
@@ -179,6 +374,12 @@ new_output_notify(struct wl_listener *listener, void *data)
 	wl_signal_add(&wlr_output->events.destroy, &output->destroy);
 	output->frame.notify = output_frame_notify;
 	wl_signal_add(&wlr_output->events.frame, &output->frame);
+	output->present.notify = output_present_notify;
+	wl_signal_add(&wlr_output->events.present, &output->present);
+	output->commit.notify = output_commit_notify;
+	wl_signal_add(&wlr_output->events.commit, &output->commit);
+	output->render_timer = wl_event_loop_add_timer(server->wl_event_loop,
+		handle_render_timer, output);
 
 	wl_list_init(&output->regions);
 
@@ -219,6 +420,7 @@ new_output_notify(struct wl_listener *listener, void *data)
 	wlr_scene_node_raise_to_top(&output->layer_tree[3]->node);
 	wlr_scene_node_raise_to_top(&output->layer_popup_tree->node);
 	wlr_scene_node_raise_to_top(&output->session_lock_tree->node);
+	server->scene_generation++;
 
 	/*
 	 * Wait until wlr_output_layout_add_auto() returns before
@@ -227,9 +429,14 @@ new_output_notify(struct wl_listener *listener, void *data)
 	 */
 	server->pending_output_layout_change++;
 
-	wlr_output_layout_add_auto(server->output_layout, wlr_output);
-	output->scene_output = wlr_scene_get_scene_output(server->scene, wlr_output);
-	assert(output->scene_output);
+	/* Mirror targets show the source output instead of the scene */
+	mirror_init(output);
+	if (!output->mirror_of) {
+		wlr_output_layout_add_auto(server->output_layout, wlr_output);
+		output->scene_output =
+			wlr_scene_get_scene_output(server->scene, wlr_output);
+		assert(output->scene_output);
+	}
 
 	/* Create regions from config */
 	regions_reconfigure_output(output);
@@ -238,6 +445,9 @@ new_output_notify(struct wl_listener *listener, void *data)
 		session_lock_output_create(server->session_lock, output);
 	}
 
+	/* Have cursor images ready for the scale of the new output */
+	cursor_cache_update_scales(&server->seat);
+
 	server->pending_output_layout_change--;
 	do_output_layout_change(server);
 }
@@ -271,6 +481,7 @@ output_init(struct server *server)
 static void
 output_update_for_layout_change(struct server *server)
 {
+	server->scene_generation++;
 	output_update_all_usable_areas(server, /*layout_changed*/ true);
 
 	/*
@@ -282,43 +493,136 @@ output_update_for_layout_change(struct server *server)
 	cursor_update_image(&server->seat);
 }
 
+/* Output state saved before applying a configuration, used for rollback */
+struct saved_output_state {
+	struct wlr_output *wlr_output;
+	bool enabled;
+	struct wlr_output_mode *mode;
+	int32_t width, height, refresh;
+	float scale;
+	enum wl_output_transform transform;
+	bool adaptive_sync;
+};
+
 static void
+output_config_head_set_pending(struct output *output,
+		struct wlr_output_configuration_head_v1 *head)
+{
+	struct wlr_output *o = output->wlr_output;
+	bool output_enabled = head->state.enabled && !output->leased;
+
+	wlr_output_enable(o, output_enabled);
+	if (output_enabled) {
+		/* Output specifc actions only */
+		if (head->state.mode) {
+			wlr_output_set_mode(o, head->state.mode);
+		} else {
+			int32_t width = head->state.custom_mode.width;
+			int32_t height = head->state.custom_mode.height;
+			int32_t refresh = head->state.custom_mode.refresh;
+			wlr_output_set_custom_mode(o, width,
+				height, refresh);
+		}
+		wlr_output_set_scale(o, head->state.scale);
+		wlr_output_set_transform(o, head->state.transform);
+		wlr_output_enable_adaptive_sync(o, head->state.adaptive_sync_enabled);
+	}
+}
+
+static void
+output_state_save(struct saved_output_state *saved, struct wlr_output *o)
+{
+	saved->wlr_output = o;
+	saved->enabled = o->enabled;
+	saved->mode = o->current_mode;
+	saved->width = o->width;
+	saved->height = o->height;
+	saved->refresh = o->refresh;
+	saved->scale = o->scale;
+	saved->transform = o->transform;
+	saved->adaptive_sync =
+		o->adaptive_sync_status == WLR_OUTPUT_ADAPTIVE_SYNC_ENABLED;
+}
+
+static void
+output_state_restore(struct saved_output_state *saved)
+{
+	struct wlr_output *o = saved->wlr_output;
+
+	wlr_output_enable(o, saved->enabled);
+	if (saved->enabled) {
+		if (saved->mode) {
+			wlr_output_set_mode(o, saved->mode);
+		} else {
+			wlr_output_set_custom_mode(o, saved->width,
+				saved->height, saved->refresh);
+		}
+		wlr_output_set_scale(o, saved->scale);
+		wlr_output_set_transform(o, saved->transform);
+		wlr_output_enable_adaptive_sync(o, saved->adaptive_sync);
+	}
+	if (!wlr_output_commit(o)) {
+		wlr_log(WLR_ERROR, "failed to restore state of output %s",
+			o->name);
+	}
+}
+
+/*
+ * Commit the new state of all heads and only then update the layout. If
+ * any commit fails, the heads committed so far are reverted to their
+ * previous state so that a configuration is either applied as a whole or
+ * not at all.
+ *
+ * Returns true on success.
+ */
+static bool
 output_config_apply(struct server *server,
 		struct wlr_output_configuration_v1 *config)
 {
+	bool success = true;
 	server->pending_output_layout_change++;
 
+	struct saved_output_state *saved =
+		znew_n(*saved, wl_list_length(&config->heads));
+	size_t nr_committed = 0;
+
 	struct wlr_output_configuration_head_v1 *head;
 	wl_list_for_each(head, &config->heads, link) {
 		struct wlr_output *o = head->state.output;
 		struct output *output = output_from_wlr_output(server, o);
-		bool output_enabled = head->state.enabled && !output->leased;
-		bool need_to_add = output_enabled && !o->enabled;
-		bool need_to_remove = !output_enabled && o->enabled;
 
-		wlr_output_enable(o, output_enabled);
-		if (output_enabled) {
-			/* Output specifc actions only */
-			if (head->state.mode) {
-				wlr_output_set_mode(o, head->state.mode);
-			} else {
-				int32_t width = head->state.custom_mode.width;
-				int32_t height = head->state.custom_mode.height;
-				int32_t refresh = head->state.custom_mode.refresh;
-				wlr_output_set_custom_mode(o, width,
-					height, refresh);
-			}
-			wlr_output_set_scale(o, head->state.scale);
-			wlr_output_set_transform(o, head->state.transform);
-			wlr_output_enable_adaptive_sync(o, head->state.adaptive_sync_enabled);
-		}
+		output_state_save(&saved[nr_committed], o);
+		output_config_head_set_pending(output, head);
 		if (!wlr_output_commit(o)) {
-			wlr_log(WLR_ERROR, "Output config commit failed");
-			continue;
+			wlr_log(WLR_ERROR, "Output config commit failed for %s",
+				o->name);
+			wlr_output_rollback(o);
+			success = false;
+			break;
 		}
+		nr_committed++;
+	}
 
-		/* Only do Layout specific actions if the commit went trough */
-		if (need_to_add) {
+	if (!success) {
+		while (nr_committed--) {
+			output_state_restore(&saved[nr_committed]);
+		}
+		goto out;
+	}
+
+	/* Only do Layout specific actions once all commits went through */
+	wl_list_for_each(head, &config->heads, link) {
+		struct wlr_output *o = head->state.output;
+		struct output *output = output_from_wlr_output(server, o);
+		bool output_enabled = head->state.enabled && !output->leased
+			&& !output->mirror_of;
+		bool in_layout = wlr_output_layout_get(server->output_layout, o);
+
+		/* The configured adaptive sync state takes precedence */
+		output->adaptive_sync_by_rule = false;
+		mode_cache_store(o);
+
+		if (output_enabled && !in_layout) {
 			wlr_output_layout_add_auto(server->output_layout, o);
 			output->scene_output =
 				wlr_scene_get_scene_output(server->scene, o);
@@ -335,21 +639,48 @@ output_config_apply(struct server *server,
 			}
 		}
 
-		if (need_to_remove) {
+		if (!output_enabled && in_layout) {
 			regions_evacuate_output(output);
 			wlr_output_layout_remove(server->output_layout, o);
 			output->scene_output = NULL;
+			visibility_arm_fallback(server);
 		}
 	}
 
+out:
+	free(saved);
 	server->pending_output_layout_change--;
 	do_output_layout_change(server);
+	return success;
 }
 
+/*
+ * Test the pending state of every head without committing anything, so
+ * that a configuration which any output would reject is refused before
+ * touching the outputs at all.
+ */
 static bool
-verify_output_config_v1(const struct wlr_output_configuration_v1 *config)
+verify_output_config_v1(struct server *server,
+		struct wlr_output_configuration_v1 *config)
 {
-	/* TODO implement */
+	struct wlr_output_configuration_head_v1 *head;
+	wl_list_for_each(head, &config->heads, link) {
+		struct wlr_output *o = head->state.output;
+		struct output *output = output_from_wlr_output(server, o);
+		if (!output) {
+			wlr_log(WLR_ERROR, "Output config refers to unknown output %s",
+				o->name);
+			return false;
+		}
+		output_config_head_set_pending(output, head);
+		bool ok = wlr_output_test(o);
+		wlr_output_rollback(o);
+		if (!ok) {
+			wlr_log(WLR_INFO, "Output config test failed for %s",
+				o->name);
+			return false;
+		}
+	}
 	return true;
 }
 
@@ -360,20 +691,15 @@ handle_output_manager_apply(struct wl_listener *listener, void *data)
 		wl_container_of(listener, server, output_manager_apply);
 	struct wlr_output_configuration_v1 *config = data;
 
-	bool config_is_good = verify_output_config_v1(config);
+	bool config_is_good = verify_output_config_v1(server, config);
 
-	if (config_is_good) {
-		output_config_apply(server, config);
+	if (config_is_good && output_config_apply(server, config)) {
 		wlr_output_configuration_v1_send_succeeded(config);
 	} else {
 		wlr_output_configuration_v1_send_failed(config);
 	}
 	wlr_output_configuration_v1_destroy(config);
-	struct output *output;
-	wl_list_for_each(output, &server->outputs, link) {
-		wlr_xcursor_manager_load(server->seat.xcursor_manager,
-			output->wlr_output->scale);
-	}
+	cursor_cache_update_scales(&server->seat);
 
 	/* Re-set cursor image in case scale changed */
 	cursor_update_focus(server);
@@ -412,28 +738,56 @@ wlr_output_configuration_v1 *create_output_config(struct server *server)
 		if (!wlr_box_empty(&box)) {
 			head->state.x = box.x;
 			head->state.y = box.y;
-		} else {
+		} else if (!output->mirror_of) {
 			wlr_log(WLR_ERROR, "failed to get output layout box");
 		}
 	}
 	return config;
 }
 
+static int
+handle_output_layout_change_timer(void *data)
+{
+	struct server *server = data;
+	server->output_layout_change_scheduled = false;
+	server->pending_output_layout_change--;
+	if (server->pending_output_layout_change) {
+		return 0;
+	}
+
+	struct wlr_output_configuration_v1 *config =
+		create_output_config(server);
+	if (config) {
+		wlr_output_manager_v1_set_configuration(
+			server->output_manager, config);
+	} else {
+		wlr_log(WLR_ERROR,
+			"wlr_output_manager_v1_set_configuration()");
+	}
+	output_update_for_layout_change(server);
+	return 0;
+}
+
+/*
+ * Undocking or waking up monitors causes a burst of new_output, destroy
+ * and layout change events. Rather than re-arranging all views for each
+ * of them, wait until no further event has arrived for a short while.
+ */
 static void
 do_output_layout_change(struct server *server)
 {
-	if (!server->pending_output_layout_change) {
-		struct wlr_output_configuration_v1 *config =
-			create_output_config(server);
-		if (config) {
-			wlr_output_manager_v1_set_configuration(
-				server->output_manager, config);
-		} else {
-			wlr_log(WLR_ERROR,
-				"wlr_output_manager_v1_set_configuration()");
-		}
-		output_update_for_layout_change(server);
+	if (server->output_layout_change_scheduled) {
+		wl_event_source_timer_update(server->output_layout_change_timer,
+			OUTPUT_LAYOUT_CHANGE_DELAY_MS);
+		return;
 	}
+	if (server->pending_output_layout_change) {
+		return;
+	}
+	server->pending_output_layout_change++;
+	server->output_layout_change_scheduled = true;
+	wl_event_source_timer_update(server->output_layout_change_timer,
+		OUTPUT_LAYOUT_CHANGE_DELAY_MS);
 }
 
 static void
@@ -441,6 +795,7 @@ handle_output_layout_change(struct wl_listener *listener, void *data)
 {
 	struct server *server =
 		wl_container_of(listener, server, output_layout_change);
+	hit_index_on_layout_change(server);
 	do_output_layout_change(server);
 }
 
@@ -449,6 +804,10 @@ output_manager_init(struct server *server)
 {
 	server->output_manager = wlr_output_manager_v1_create(server->wl_display);
 
+	server->output_layout_change_timer = wl_event_loop_add_timer(
+		server->wl_event_loop, handle_output_layout_change_timer,
+		server);
+
 	server->output_layout_change.notify = handle_output_layout_change;
 	wl_signal_add(&server->output_layout->events.change,
 		&server->output_layout_change);
@@ -458,6 +817,15 @@ output_manager_init(struct server *server)
 		&server->output_manager_apply);
 }
 
+void
+output_finish(struct server *server)
+{
+	if (server->output_layout_change_timer) {
+		wl_event_source_remove(server->output_layout_change_timer);
+		server->output_layout_change_timer = NULL;
+	}
+}
+
 struct output *
 output_from_wlr_output(struct server *server, struct wlr_output *wlr_output)
 {
@@ -508,7 +876,8 @@ bool
 output_is_usable(struct output *output)
 {
 	/* output_is_usable(NULL) is safe and returns false */
-	return output && output->wlr_output->enabled && !output->leased;
+	return output && output->wlr_output->enabled && !output->leased
+		&& !output->mirror_of;
 }
 
 /* returns true if usable area changed */
@@ -517,6 +886,8 @@ update_usable_area(struct output *output)
 {
 	struct wlr_box old = output->usable_area;
 	layers_arrange(output);
+	/* Layer surfaces may have been moved */
+	output->server->scene_generation++;
 
 	return !wlr_box_equal(&old, &output->usable_area);
 }
@@ -567,12 +938,16 @@ output_usable_area_in_layout_coords(struct output *output)
 void
 handle_output_power_manager_set_mode(struct wl_listener *listener, void *data)
 {
+	struct server *server = wl_container_of(listener, server,
+		output_power_manager_set_mode);
 	struct wlr_output_power_v1_set_mode_event *event = data;
 
 	switch (event->mode) {
 	case ZWLR_OUTPUT_POWER_V1_MODE_OFF:
 		wlr_output_enable(event->output, false);
 		wlr_output_commit(event->output);
+		server->scene_generation++;
+		visibility_arm_fallback(server);
 		break;
 	case ZWLR_OUTPUT_POWER_V1_MODE_ON:
 		wlr_output_enable(event->output, true);
@@ -580,6 +955,7 @@ handle_output_power_manager_set_mode(struct wl_listener *listener, void *data)
 			wlr_output_rollback(event->output);
 		}
 		wlr_output_commit(event->output);
+		server->scene_generation++;
 		break;
 	}
 }
@@ -135,6 +135,7 @@ regions_show_overlay(struct view *view, struct seat *seat, struct region *region
 	wlr_scene_node_set_position(node, region->geo.x, region->geo.y);
 	wlr_scene_node_set_enabled(node, true);
 	seat->region_active = region;
+	server->scene_generation++;
 }
 
 void
@@ -153,6 +154,7 @@ regions_hide_overlay(struct seat *seat)
 		wlr_scene_node_reparent(node, &server->scene->tree);
 	}
 	seat->region_active = NULL;
+	server->scene_generation++;
 }
 
 void
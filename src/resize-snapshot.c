@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: GPL-2.0-only
+#include <assert.h>
+#include <math.h>
+#include <wlr/types/wlr_scene.h>
+#include "common/mem.h"
+#include "labwc.h"
+#include "resize-snapshot.h"
+#include "view.h"
+#include "view-impl-common.h"
+
+struct snapshot_buffer {
+	struct wlr_scene_buffer *scene_buffer;
+	/* Position and size relative to the snapshot tree when taken */
+	struct wlr_box box;
+};
+
+struct resize_snapshot {
+	struct wlr_scene_tree *tree;
+	struct wl_array buffers; /* struct snapshot_buffer */
+
+	/* Size of the surface when the snapshot was taken */
+	int base_width, base_height;
+	/* Size last committed by the client */
+	int live_width, live_height;
+	/* Whether the snapshot (rather than the live surface) is shown */
+	bool shown;
+};
+
+static void
+copy_buffer(struct wlr_scene_buffer *buffer, int sx, int sy, void *data)
+{
+	struct resize_snapshot *snapshot = data;
+	if (!buffer->buffer) {
+		return;
+	}
+
+	struct wlr_scene_buffer *copy =
+		wlr_scene_buffer_create(snapshot->tree, buffer->buffer);
+	if (!copy) {
+		wlr_log(WLR_ERROR, "unable to create snapshot buffer");
+		return;
+	}
+	wlr_scene_buffer_set_source_box(copy, &buffer->src_box);
+	wlr_scene_buffer_set_transform(copy, buffer->transform);
+
+	struct snapshot_buffer *entry =
+		wl_array_add(&snapshot->buffers, sizeof(*entry));
+	if (!entry) {
+		wlr_scene_node_destroy(&copy->node);
+		return;
+	}
+	entry->scene_buffer = copy;
+	entry->box = (struct wlr_box){
+		.x = sx,
+		.y = sy,
+		.width = buffer->dst_width ? buffer->dst_width
+			: buffer->buffer->width,
+		.height = buffer->dst_height ? buffer->dst_height
+			: buffer->buffer->height,
+	};
+}
+
+/* Replace the snapshot content by the current buffers of the live surface */
+static void
+take(struct view *view)
+{
+	struct resize_snapshot *snapshot = view->resize_snapshot;
+
+	struct snapshot_buffer *entry;
+	wl_array_for_each(entry, &snapshot->buffers) {
+		wlr_scene_node_destroy(&entry->scene_buffer->node);
+	}
+	snapshot->buffers.size = 0;
+
+	wlr_scene_node_set_position(&snapshot->tree->node,
+		view->scene_node->x, view->scene_node->y);
+	wlr_scene_node_for_each_buffer(view->scene_node, copy_buffer,
+		snapshot);
+	snapshot->base_width = snapshot->live_width;
+	snapshot->base_height = snapshot->live_height;
+}
+
+/* Stretch the snapshot to the current geometry of the view */
+static void
+layout(struct view *view)
+{
+	struct resize_snapshot *snapshot = view->resize_snapshot;
+	if (snapshot->base_width <= 0 || snapshot->base_height <= 0) {
+		return;
+	}
+	double scale_x = (double)view->current.width / snapshot->base_width;
+	double scale_y = (double)view->current.height / snapshot->base_height;
+
+	struct snapshot_buffer *entry;
+	wl_array_for_each(entry, &snapshot->buffers) {
+		struct wlr_box *box = &entry->box;
+		int x1 = lround(box->x * scale_x);
+		int y1 = lround(box->y * scale_y);
+		int x2 = lround((box->x + box->width) * scale_x);
+		int y2 = lround((box->y + box->height) * scale_y);
+		wlr_scene_node_set_position(&entry->scene_buffer->node, x1, y1);
+		wlr_scene_buffer_set_dest_size(entry->scene_buffer,
+			MAX(x2 - x1, 1), MAX(y2 - y1, 1));
+	}
+}
+
+/*
+ * Show the live surface if it matches the current geometry of the view,
+ * otherwise show the snapshot stretched to that geometry.
+ */
+static void
+update(struct view *view)
+{
+	struct resize_snapshot *snapshot = view->resize_snapshot;
+	bool matches = snapshot->live_width == view->current.width
+		&& snapshot->live_height == view->current.height;
+
+	if (matches) {
+		if (snapshot->shown) {
+			wlr_scene_node_set_enabled(&snapshot->tree->node, false);
+			wlr_scene_node_set_enabled(view->scene_node, true);
+			snapshot->shown = false;
+		}
+		return;
+	}
+
+	if (!snapshot->shown) {
+		/* The live surface holds the most recent content */
+		take(view);
+		wlr_scene_node_set_enabled(view->scene_node, false);
+		wlr_scene_node_set_enabled(&snapshot->tree->node, true);
+		snapshot->shown = true;
+	}
+	layout(view);
+}
+
+void
+resize_snapshot_begin(struct view *view)
+{
+	assert(view);
+	if (!rc.resize_snapshot || view->type != LAB_XDG_SHELL_VIEW
+			|| !view->scene_node || view->resize_snapshot) {
+		return;
+	}
+
+	struct resize_snapshot *snapshot = znew(*snapshot);
+	snapshot->tree = wlr_scene_tree_create(view->scene_tree);
+	if (!snapshot->tree) {
+		free(snapshot);
+		return;
+	}
+	wlr_scene_node_set_enabled(&snapshot->tree->node, false);
+	wl_array_init(&snapshot->buffers);
+	snapshot->live_width = view->current.width;
+	snapshot->live_height = view->current.height;
+	view->resize_snapshot = snapshot;
+}
+
+void
+resize_snapshot_destroy(struct view *view)
+{
+	struct resize_snapshot *snapshot = view->resize_snapshot;
+	if (!snapshot) {
+		return;
+	}
+	/* Also destroys the copies, which release their buffers */
+	wlr_scene_node_destroy(&snapshot->tree->node);
+	wl_array_release(&snapshot->buffers);
+	free(snapshot);
+	view->resize_snapshot = NULL;
+}
+
+void
+resize_snapshot_end(struct view *view)
+{
+	struct resize_snapshot *snapshot = view->resize_snapshot;
+	if (!snapshot) {
+		return;
+	}
+	int width = snapshot->live_width;
+	int height = snapshot->live_height;
+	bool shown = snapshot->shown;
+
+	resize_snapshot_destroy(view);
+	if (shown) {
+		wlr_scene_node_set_enabled(view->scene_node, true);
+	}
+
+	/*
+	 * The geometry of the view follows the compositor's requests in
+	 * snapshot mode. Go back to the size the client actually committed;
+	 * later commits are processed as usual.
+	 */
+	view_impl_apply_geometry(view, width, height);
+}
+
+void
+resize_snapshot_set_geometry(struct view *view, struct wlr_box geo)
+{
+	assert(view->resize_snapshot);
+	if (!wlr_box_equal(&view->current, &geo)) {
+		view->current = geo;
+		view_moved(view);
+	}
+	update(view);
+}
+
+void
+resize_snapshot_handle_commit(struct view *view, int width, int height)
+{
+	struct resize_snapshot *snapshot = view->resize_snapshot;
+	assert(snapshot);
+	bool resized = snapshot->live_width != width
+		|| snapshot->live_height != height;
+	snapshot->live_width = width;
+	snapshot->live_height = height;
+
+	if (snapshot->shown && resized) {
+		/*
+		 * The client has caught up with an earlier request, so its
+		 * new content is a better approximation than the snapshot.
+		 * Swap the live surface in so that update() takes a new one
+		 * if the size still does not match.
+		 */
+		wlr_scene_node_set_enabled(&snapshot->tree->node, false);
+		wlr_scene_node_set_enabled(view->scene_node, true);
+		snapshot->shown = false;
+	}
+	update(view);
+}
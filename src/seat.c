@@ -9,6 +9,7 @@
 #include <wlr/types/wlr_touch.h>
 #include <wlr/util/log.h>
 #include "common/mem.h"
+#include "fullscreen.h"
 #include "key-state.h"
 #include "labwc.h"
 
@@ -471,11 +472,14 @@ seat_set_focus_layer(struct seat *seat, struct wlr_layer_surface_v1 *layer)
 	if (!layer) {
 		seat->focused_layer = NULL;
 		desktop_focus_topmost_mapped_view(seat->server);
+		fullscreen_update(seat->server);
 		return;
 	}
 	seat_focus(seat, layer->surface);
 	if (layer->current.layer >= ZWLR_LAYER_SHELL_V1_LAYER_TOP) {
 		seat->focused_layer = layer;
+		/* Leave exclusive fullscreen so that the layer is shown */
+		fullscreen_update(seat->server);
 	}
 }
 
@@ -524,3 +528,52 @@ seat_reset_pressed(struct seat *seat)
 	seat->pressed.toplevel = NULL;
 	seat->pressed.resize_edges = 0;
 }
+
+/*
+ * Keyboard input usually changes the focused view, pointer and touch
+ * input whatever is under the cursor.
+ */
+static struct output *
+latency_output(struct seat *seat, struct wlr_input_device *device)
+{
+	struct view *view = seat->server->focused_view;
+	if (device->type == WLR_INPUT_DEVICE_KEYBOARD && view
+			&& output_is_usable(view->output)) {
+		return view->output;
+	}
+	return output_nearest_to_cursor(seat->server);
+}
+
+void
+seat_record_input_event(struct seat *seat, struct wlr_input_device *device,
+		uint32_t time_msec)
+{
+	struct input *input;
+	wl_list_for_each(input, &seat->inputs, link) {
+		if (input->wlr_input_device == device) {
+			input_latency_record_event(&input->latency, time_msec,
+				latency_output(seat, device));
+			return;
+		}
+	}
+}
+
+void
+seat_record_present(struct seat *seat, struct output *output,
+		const struct timespec *commit, const struct timespec *when)
+{
+	struct input *input;
+	wl_list_for_each(input, &seat->inputs, link) {
+		input_latency_record_present(&input->latency, output, commit,
+			when);
+	}
+}
+
+void
+seat_on_output_destroy(struct seat *seat, struct output *output)
+{
+	struct input *input;
+	wl_list_for_each(input, &seat->inputs, link) {
+		input_latency_on_output_destroy(&input->latency, output);
+	}
+}
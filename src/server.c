@@ -19,14 +19,17 @@
 #include "config/rcxml.h"
 #include "config/session.h"
 #include "decorations.h"
+#include "hud.h"
 #include "idle.h"
 #include "labwc.h"
 #include "layers.h"
 #include "menu/menu.h"
+#include "mode-cache.h"
 #include "regions.h"
 #include "resize_indicator.h"
 #include "theme.h"
 #include "view.h"
+#include "visibility.h"
 #include "workspaces.h"
 #include "xwayland.h"
 
@@ -323,6 +326,7 @@ server_init(struct server *server)
 	workspaces_init(server);
 
 	output_init(server);
+	visibility_init(server);
 
 	/*
 	 * Create some hands-off wlroots interfaces. The compositor is
@@ -491,9 +495,16 @@ server_finish(struct server *server)
 	if (sighup_source) {
 		wl_event_source_remove(sighup_source);
 	}
+	if (server->pending_raise.timer) {
+		wl_event_source_remove(server->pending_raise.timer);
+	}
 	wl_display_destroy_clients(server->wl_display);
 
 	seat_finish(server);
+	output_finish(server);
+	hud_finish(server);
+	visibility_finish(server);
+	mode_cache_finish();
 	wlr_output_layout_destroy(server->output_layout);
 
 	wl_display_destroy(server->wl_display);
@@ -57,6 +57,7 @@ static void
 handle_surface_map(struct wl_listener *listener, void *data)
 {
 	struct session_lock_output *surf = wl_container_of(listener, surf, surface_map);
+	g_server->scene_generation++;
 	if (!surf->lock->focused) {
 		focus_surface(surf->lock, surf->surface->surface);
 	}
@@ -211,6 +212,7 @@ session_lock_destroy(struct session_lock *lock)
 	wl_list_for_each_safe(lock_output, next, &lock->session_lock_outputs, link) {
 		wlr_scene_node_destroy(&lock_output->tree->node);
 	}
+	g_server->scene_generation++;
 	if (g_server->session_lock == lock) {
 		g_server->session_lock = NULL;
 	}
@@ -288,6 +290,7 @@ handle_new_session_lock(struct wl_listener *listener, void *data)
 
 	wlr_session_lock_v1_send_locked(lock);
 	g_server->session_lock = session_lock;
+	g_server->scene_generation++;
 }
 
 static void
@@ -45,6 +45,7 @@ touch_motion(struct wl_listener *listener, void *data)
 	struct seat *seat = wl_container_of(listener, seat, touch_motion);
 	struct wlr_touch_motion_event *event = data;
 	idle_manager_notify_activity(seat->seat);
+	seat_record_input_event(seat, &event->touch->base, event->time_msec);
 
 	/* Convert coordinates: first [0, 1] => layout, then apply offsets */
 	double lx, ly;
@@ -78,6 +79,7 @@ touch_down(struct wl_listener *listener, void *data)
 {
 	struct seat *seat = wl_container_of(listener, seat, touch_down);
 	struct wlr_touch_down_event *event = data;
+	seat_record_input_event(seat, &event->touch->base, event->time_msec);
 
 	/* Compute layout => surface offset and save for this touch point */
 	double x_offset, y_offset;
@@ -110,6 +112,7 @@ touch_up(struct wl_listener *listener, void *data)
 {
 	struct seat *seat = wl_container_of(listener, seat, touch_up);
 	struct wlr_touch_up_event *event = data;
+	seat_record_input_event(seat, &event->touch->base, event->time_msec);
 
 	/* Remove the touch point from the seat */
 	struct touch_point *touch_point, *tmp;
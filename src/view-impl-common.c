@@ -15,6 +15,7 @@ view_impl_move_to_front(struct view *view)
 	wl_list_remove(&view->link);
 	wl_list_insert(&view->server->views, &view->link);
 	wlr_scene_node_raise_to_top(&view->scene_tree->node);
+	view->server->scene_generation++;
 }
 
 void
@@ -23,6 +24,7 @@ view_impl_move_to_back(struct view *view)
 	wl_list_remove(&view->link);
 	wl_list_append(&view->server->views, &view->link);
 	wlr_scene_node_lower_to_bottom(&view->scene_tree->node);
+	view->server->scene_generation++;
 }
 
 void
@@ -4,10 +4,13 @@
 #include <strings.h>
 #include "common/mem.h"
 #include "common/scene-helpers.h"
+#include "fullscreen.h"
+#include "hit-index.h"
 #include "labwc.h"
 #include "menu/menu.h"
 #include "regions.h"
 #include "resize_indicator.h"
+#include "resize-snapshot.h"
 #include "ssd.h"
 #include "view.h"
 #include "window-rules.h"
@@ -200,6 +203,7 @@ view_set_activated(struct view *view)
 	}
 	_view_set_activated(view, true);
 	view->server->focused_view = view;
+	fullscreen_update(view->server);
 }
 
 void
@@ -211,7 +215,10 @@ view_set_output(struct view *view, struct output *output)
 		wlr_log(WLR_ERROR, "invalid output set for view");
 		return;
 	}
-	view->output = output;
+	if (view->output != output) {
+		view->output = output;
+		fullscreen_update(view->server);
+	}
 }
 
 void
@@ -238,6 +245,7 @@ void
 view_moved(struct view *view)
 {
 	assert(view);
+	view->server->scene_generation++;
 	wlr_scene_node_set_position(&view->scene_tree->node,
 		view->current.x, view->current.y);
 	/*
@@ -249,6 +257,7 @@ view_moved(struct view *view)
 		view_discover_output(view);
 	}
 	ssd_update_geometry(view->ssd);
+	hit_index_view_damage(view);
 	cursor_update_focus(view->server);
 	if (view->toplevel.handle) {
 		foreign_toplevel_update_outputs(view);
@@ -341,6 +350,8 @@ _minimize(struct view *view, bool minimized)
 			 */
 			view->server->focused_view = NULL;
 		}
+		/* Adaptive sync may have been enabled for the view */
+		fullscreen_update(view->server);
 	} else {
 		view->impl->map(view);
 	}
@@ -750,6 +761,8 @@ view_toggle_decorations(struct view *view)
 		if (!view_is_floating(view)) {
 			view_apply_special_geometry(view);
 		}
+		hit_index_view_damage(view);
+		view->server->scene_generation++;
 		return;
 	}
 	view_set_decorations(view, !view->ssd_enabled);
@@ -775,6 +788,7 @@ view_toggle_always_on_top(struct view *view)
 		wlr_scene_node_reparent(&view->scene_tree->node,
 			view->server->view_tree_always_on_top);
 	}
+	view->server->scene_generation++;
 }
 
 static bool
@@ -797,6 +811,7 @@ view_toggle_always_on_bottom(struct view *view)
 		wlr_scene_node_reparent(&view->scene_tree->node,
 			view->server->view_tree_always_on_bottom);
 	}
+	view->server->scene_generation++;
 }
 
 void
@@ -808,6 +823,7 @@ view_move_to_workspace(struct view *view, struct workspace *workspace)
 		view->workspace = workspace;
 		wlr_scene_node_reparent(&view->scene_tree->node,
 			workspace->tree);
+		view->server->scene_generation++;
 	}
 }
 
@@ -847,6 +863,8 @@ view_set_decorations(struct view *view, bool decorations)
 		if (!view_is_floating(view)) {
 			view_apply_special_geometry(view);
 		}
+		hit_index_view_damage(view);
+		view->server->scene_generation++;
 	}
 }
 
@@ -879,6 +897,7 @@ set_fullscreen(struct view *view, bool fullscreen)
 	if (!fullscreen && view->ssd_enabled) {
 		decorate(view);
 	}
+	hit_index_view_damage(view);
 
 	/* Show fullscreen views above top-layer */
 	if (view->output) {
@@ -886,6 +905,8 @@ set_fullscreen(struct view *view, bool fullscreen)
 		wlr_scene_node_set_enabled(&view->output->layer_tree[top]->node,
 			!fullscreen);
 	}
+	view->server->scene_generation++;
+	fullscreen_update(view->server);
 }
 
 void
@@ -974,6 +995,9 @@ view_on_output_destroy(struct view *view)
 	 * shortly afterward, which will exit fullscreen.
 	 */
 	view->output = NULL;
+	if (view->fullscreen) {
+		fullscreen_update(view->server);
+	}
 }
 
 void
@@ -1232,6 +1256,7 @@ view_reload_ssd(struct view *view)
 	if (view->ssd_enabled && !view->fullscreen) {
 		undecorate(view);
 		decorate(view);
+		hit_index_view_damage(view);
 	}
 }
 
@@ -1272,6 +1297,10 @@ view_destroy(struct view *view)
 	struct server *server = view->server;
 	bool need_cursor_update = false;
 
+	hit_index_on_view_destroy(view);
+	resize_snapshot_destroy(view);
+	desktop_cancel_raise(server, view);
+	server->scene_generation++;
 	wl_list_remove(&view->map.link);
 	wl_list_remove(&view->unmap.link);
 	wl_list_remove(&view->request_move.link);
@@ -1297,6 +1326,7 @@ view_destroy(struct view *view)
 	if (server->focused_view == view) {
 		server->focused_view = NULL;
 		need_cursor_update = true;
+		fullscreen_update(server);
 	}
 
 	if (server->seat.pressed.view == view) {
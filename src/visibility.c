@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Visibility tracking and frame-done throttling
+ *
+ * Clients only render when they receive frame-done events, so throttling
+ * those events for views that cannot be seen stops hidden browsers and video
+ * players from burning CPU/GPU time. Rather than stopping them completely,
+ * invisible views get frame-done events from a low frequency fallback timer.
+ *
+ * Visibility is only recomputed on a frame when server->scene_generation
+ * or the opaque region of a view has changed. The fallback timer always
+ * recomputes it.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include <pixman.h>
+#include <time.h>
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
+#include "common/scene-helpers.h"
+#include "labwc.h"
+#include "node.h"
+#include "view.h"
+#include "visibility.h"
+
+#define FALLBACK_FRAME_INTERVAL_MS 1000
+
+static struct wl_event_source *fallback_timer;
+static bool fallback_timer_armed;
+
+/* Scene generation that view->visible was computed for */
+static struct {
+	uint64_t generation;
+	bool valid;
+} cache;
+
+static struct wlr_scene_node *
+find_surface_node(struct wlr_scene_node *node, struct wlr_surface *surface)
+{
+	if (lab_wlr_surface_from_node(node) == surface) {
+		return node;
+	}
+	if (node->type != WLR_SCENE_NODE_TREE) {
+		return NULL;
+	}
+	struct wlr_scene_node *child;
+	struct wlr_scene_tree *tree = lab_scene_tree_from_node(node);
+	wl_list_for_each(child, &tree->children, link) {
+		struct wlr_scene_node *found = find_surface_node(child, surface);
+		if (found) {
+			return found;
+		}
+	}
+	return NULL;
+}
+
+static void
+update_view(struct view *view, pixman_region32_t *covered,
+		pixman_region32_t *outputs)
+{
+	if (!view->mapped || !view->surface || !view->scene_node) {
+		return;
+	}
+
+	struct wlr_box *box = &view->current;
+	pixman_region32_t visible;
+	pixman_region32_init_rect(&visible, box->x, box->y,
+		box->width, box->height);
+	pixman_region32_intersect(&visible, &visible, outputs);
+	pixman_region32_subtract(&visible, &visible, covered);
+	view->visible = pixman_region32_not_empty(&visible);
+	pixman_region32_fini(&visible);
+
+	/* Views stacked below are covered by the opaque part of this one */
+	struct wlr_scene_node *node =
+		find_surface_node(view->scene_node, view->surface);
+	if (!node) {
+		return;
+	}
+	int lx, ly;
+	wlr_scene_node_coords(node, &lx, &ly);
+	pixman_region32_t opaque;
+	pixman_region32_init(&opaque);
+	pixman_region32_copy(&opaque, &view->surface->opaque_region);
+	pixman_region32_translate(&opaque, lx, ly);
+	pixman_region32_union(covered, covered, &opaque);
+	pixman_region32_fini(&opaque);
+}
+
+/* Walk views from top to bottom, skipping disabled subtrees */
+static void
+update_tree(struct wlr_scene_tree *tree, pixman_region32_t *covered,
+		pixman_region32_t *outputs)
+{
+	if (!tree->node.enabled) {
+		return;
+	}
+	struct wlr_scene_node *node;
+	wl_list_for_each_reverse(node, &tree->children, link) {
+		if (!node->enabled) {
+			continue;
+		}
+		struct node_descriptor *desc = node->data;
+		if (desc && desc->type == LAB_NODE_DESC_VIEW) {
+			update_view(desc->data, covered, outputs);
+		} else if (!desc && node->type == WLR_SCENE_NODE_TREE) {
+			/* workspace trees */
+			update_tree(lab_scene_tree_from_node(node), covered,
+				outputs);
+		}
+	}
+}
+
+void
+visibility_update(struct server *server)
+{
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		view->visible = false;
+	}
+
+	pixman_region32_t outputs, covered;
+	pixman_region32_init(&outputs);
+	pixman_region32_init(&covered);
+
+	struct output *output;
+	wl_list_for_each(output, &server->outputs, link) {
+		if (!output_is_usable(output)) {
+			continue;
+		}
+		struct wlr_box box;
+		wlr_output_layout_get_box(server->output_layout,
+			output->wlr_output, &box);
+		pixman_region32_union_rect(&outputs, &outputs,
+			box.x, box.y, box.width, box.height);
+	}
+
+	update_tree(server->view_tree_always_on_top, &covered, &outputs);
+	update_tree(server->view_tree, &covered, &outputs);
+	update_tree(server->view_tree_always_on_bottom, &covered, &outputs);
+
+	pixman_region32_fini(&outputs);
+	pixman_region32_fini(&covered);
+	cache.generation = server->scene_generation;
+	cache.valid = true;
+
+	if (fallback_timer_armed) {
+		return;
+	}
+	wl_list_for_each(view, &server->views, link) {
+		if (view->mapped && !view->visible) {
+			visibility_arm_fallback(server);
+			break;
+		}
+	}
+}
+
+void
+visibility_arm_fallback(struct server *server)
+{
+	if (fallback_timer_armed || !fallback_timer) {
+		return;
+	}
+	/* The timer handler re-arms itself while views are invisible */
+	wl_event_source_timer_update(fallback_timer,
+		FALLBACK_FRAME_INTERVAL_MS);
+	fallback_timer_armed = true;
+}
+
+void
+visibility_view_commit(struct view *view)
+{
+	pixman_region32_t *opaque = &view->surface->opaque_region;
+	pixman_box32_t *extents = pixman_region32_extents(opaque);
+	struct wlr_box box = {
+		.x = extents->x1,
+		.y = extents->y1,
+		.width = extents->x2 - extents->x1,
+		.height = extents->y2 - extents->y1,
+	};
+	int nr_rects = pixman_region32_n_rects(opaque);
+	if (nr_rects == view->opaque_nr_rects
+			&& wlr_box_equal(&box, &view->opaque_extents)) {
+		return;
+	}
+	/* Views stacked below may be covered or uncovered now */
+	view->opaque_extents = box;
+	view->opaque_nr_rects = nr_rects;
+	cache.valid = false;
+}
+
+static struct view *
+view_from_buffer(struct wlr_scene_buffer *buffer)
+{
+	struct wlr_scene_node *node = &buffer->node;
+	while (node) {
+		struct node_descriptor *desc = node->data;
+		if (desc && desc->type == LAB_NODE_DESC_VIEW) {
+			return desc->data;
+		}
+		node = node->parent ? &node->parent->node : NULL;
+	}
+	return NULL;
+}
+
+struct frame_done_data {
+	struct wlr_scene_output *scene_output;
+	struct timespec *now;
+};
+
+static void
+send_frame_done_iterator(struct wlr_scene_buffer *buffer, int sx, int sy,
+		void *user_data)
+{
+	struct frame_done_data *data = user_data;
+	if (buffer->primary_output != data->scene_output) {
+		return;
+	}
+	struct view *view = view_from_buffer(buffer);
+	if (view && !view->visible) {
+		/* Handled by the fallback timer */
+		return;
+	}
+	wlr_scene_buffer_send_frame_done(buffer, data->now);
+}
+
+void
+visibility_send_frame_done(struct output *output, struct timespec *now)
+{
+	struct server *server = output->server;
+	if (!cache.valid || cache.generation != server->scene_generation) {
+		visibility_update(server);
+	}
+
+	struct frame_done_data data = {
+		.scene_output = output->scene_output,
+		.now = now,
+	};
+	wlr_scene_output_for_each_buffer(output->scene_output,
+		send_frame_done_iterator, &data);
+}
+
+static void
+send_surface_frame_done(struct wlr_surface *surface, int sx, int sy,
+		void *data)
+{
+	wlr_surface_send_frame_done(surface, data);
+}
+
+static int
+handle_fallback_timer(void *data)
+{
+	struct server *server = data;
+	fallback_timer_armed = false;
+
+	/* Re-arms the timer if there are still invisible views */
+	visibility_update(server);
+
+	struct timespec now = { 0 };
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	struct view *view;
+	wl_list_for_each(view, &server->views, link) {
+		if (view->mapped && !view->visible && view->surface) {
+			wlr_surface_for_each_surface(view->surface,
+				send_surface_frame_done, &now);
+		}
+	}
+	return 0;
+}
+
+void
+visibility_init(struct server *server)
+{
+	fallback_timer = wl_event_loop_add_timer(server->wl_event_loop,
+		handle_fallback_timer, server);
+	fallback_timer_armed = false;
+	cache.valid = false;
+}
+
+void
+visibility_finish(struct server *server)
+{
+	if (fallback_timer) {
+		wl_event_source_remove(fallback_timer);
+		fallback_timer = NULL;
+	}
+}
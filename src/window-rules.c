@@ -128,6 +128,10 @@ window_rules_get_property(struct view *view, const char *property)
 					&& !strcasecmp(property, "ignoreFocusRequest")) {
 				return rule->ignore_focus_request;
 			}
+			if (rule->adaptive_sync
+					&& !strcasecmp(property, "adaptiveSync")) {
+				return rule->adaptive_sync;
+			}
 		}
 	}
 	return LAB_PROP_UNSPECIFIED;
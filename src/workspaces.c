@@ -228,6 +228,7 @@ _osd_show(struct server *server)
 			wlr_scene_node_set_enabled(&output->workspace_osd->node, true);
 		}
 	}
+	server->scene_generation++;
 	struct wlr_keyboard *keyboard = &server->seat.keyboard_group->keyboard;
 	if (keyboard_any_modifiers_pressed(keyboard)) {
 		/* Hidden by release of all modifiers */
@@ -270,6 +271,7 @@ workspaces_switch_to(struct workspace *target)
 
 	/* Enable the new workspace */
 	wlr_scene_node_set_enabled(&target->tree->node, true);
+	server->scene_generation++;
 
 	/* Save the last visited workspace */
 	server->workspace_last = server->workspace_current;
@@ -312,6 +314,7 @@ workspaces_osd_hide(struct seat *seat)
 	seat->workspace_osd_shown_by_modifier = false;
 
 	/* Update the cursor focus in case it was on top of the OSD before */
+	server->scene_generation++;
 	cursor_update_focus(server);
 }
 
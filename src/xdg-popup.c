@@ -16,6 +16,7 @@ struct xdg_popup {
 	struct view *parent_view;
 	struct wlr_xdg_popup *wlr_popup;
 
+	struct wl_listener commit;
 	struct wl_listener destroy;
 	struct wl_listener new_popup;
 };
@@ -42,10 +43,20 @@ popup_unconstrain(struct view *view, struct wlr_xdg_popup *popup)
 	wlr_xdg_popup_unconstrain_from_box(popup, &output_toplevel_box);
 }
 
+static void
+handle_xdg_popup_commit(struct wl_listener *listener, void *data)
+{
+	struct xdg_popup *popup = wl_container_of(listener, popup, commit);
+	/* Popups are mapped, resized and repositioned on commit */
+	popup->parent_view->server->scene_generation++;
+}
+
 static void
 handle_xdg_popup_destroy(struct wl_listener *listener, void *data)
 {
 	struct xdg_popup *popup = wl_container_of(listener, popup, destroy);
+	popup->parent_view->server->scene_generation++;
+	wl_list_remove(&popup->commit.link);
 	wl_list_remove(&popup->destroy.link);
 	wl_list_remove(&popup->new_popup.link);
 	free(popup);
@@ -74,6 +85,8 @@ xdg_popup_create(struct view *view, struct wlr_xdg_popup *wlr_popup)
 	popup->parent_view = view;
 	popup->wlr_popup = wlr_popup;
 
+	popup->commit.notify = handle_xdg_popup_commit;
+	wl_signal_add(&wlr_popup->base->surface->events.commit, &popup->commit);
 	popup->destroy.notify = handle_xdg_popup_destroy;
 	wl_signal_add(&wlr_popup->base->events.destroy, &popup->destroy);
 	popup->new_popup.notify = popup_handle_new_xdg_popup;
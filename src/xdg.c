@@ -2,10 +2,13 @@
 #include <assert.h>
 #include "common/mem.h"
 #include "decorations.h"
+#include "hit-index.h"
 #include "labwc.h"
 #include "node.h"
+#include "resize-snapshot.h"
 #include "view.h"
 #include "view-impl-common.h"
+#include "visibility.h"
 #include "window-rules.h"
 #include "workspaces.h"
 
@@ -78,12 +81,29 @@ has_ssd(struct view *view)
 	}
 }
 
+static void xdg_toplevel_view_configure(struct view *view, struct wlr_box geo);
+
+/* Send the geometry held back by xdg_toplevel_view_configure(), if any */
+static void
+flush_deferred_configure(struct view *view)
+{
+	if (view->has_deferred_configure) {
+		view->has_deferred_configure = false;
+		xdg_toplevel_view_configure(view, view->deferred_configure);
+	}
+}
+
 static void
 handle_commit(struct wl_listener *listener, void *data)
 {
 	struct view *view = wl_container_of(listener, view, commit);
 	struct wlr_xdg_surface *xdg_surface = xdg_surface_from_view(view);
 	assert(view->surface);
+	/* Plain buffer updates do not change what is under the cursor */
+	if (hit_index_view_damage(view)) {
+		view->server->scene_generation++;
+	}
+	visibility_view_commit(view);
 
 	struct wlr_box size;
 	wlr_xdg_surface_get_geometry(xdg_surface, &size);
@@ -101,9 +121,14 @@ handle_commit(struct wl_listener *listener, void *data)
 		update_required = true;
 	}
 
-	if (update_required) {
+	if (view->resize_snapshot) {
+		resize_snapshot_handle_commit(view, size.width, size.height);
+	} else if (update_required) {
 		view_impl_apply_geometry(view, size.width, size.height);
 	}
+	if (!view->pending_configure_serial) {
+		flush_deferred_configure(view);
+	}
 }
 
 static int
@@ -123,6 +148,7 @@ handle_configure_timeout(void *data)
 
 	view_impl_apply_geometry(view, view->current.width,
 		view->current.height);
+	flush_deferred_configure(view);
 
 	return 0; /* ignored per wl_event_loop docs */
 }
@@ -273,6 +299,29 @@ xdg_toplevel_view_configure(struct view *view, struct wlr_box geo)
 	uint32_t serial = 0;
 	view_adjust_size(view, &geo.width, &geo.height);
 
+	/* Show the new geometry right away, whatever the client does */
+	if (view->resize_snapshot) {
+		resize_snapshot_set_geometry(view, geo);
+	}
+
+	/*
+	 * During interactive resize, keep at most one configure request
+	 * in flight so that slow clients do not fall further and further
+	 * behind. Only the latest geometry is kept and sent once the client
+	 * has acked the pending request (see handle_commit()). Geometry
+	 * identical to the request in flight is dropped.
+	 */
+	struct server *server = view->server;
+	if (view->pending_configure_serial > 0
+			&& server->input_mode == LAB_INPUT_STATE_RESIZE
+			&& server->grabbed_view == view) {
+		view->deferred_configure = geo;
+		view->has_deferred_configure =
+			!wlr_box_equal(&geo, &view->pending);
+		return;
+	}
+	view->has_deferred_configure = false;
+
 	/*
 	 * We do not need to send a configure request unless the size
 	 * changed (wayland has no notion of a global position). If the
@@ -484,12 +533,15 @@ xdg_toplevel_view_map(struct view *view)
 		return;
 	}
 	view->mapped = true;
+	visibility_arm_fallback(view->server);
+	hit_index_view_damage(view);
 	if (!view->output) {
 		view_set_output(view, output_nearest_to_cursor(view->server));
 	}
 	struct wlr_xdg_surface *xdg_surface = xdg_surface_from_view(view);
 	view->surface = xdg_surface->surface;
 	wlr_scene_node_set_enabled(&view->scene_tree->node, true);
+	view->server->scene_generation++;
 	if (!view->been_mapped) {
 		struct wlr_xdg_toplevel_requested *requested =
 			&xdg_toplevel_from_view(view)->requested;
@@ -553,6 +605,9 @@ xdg_toplevel_view_unmap(struct view *view, bool client_request)
 	if (view->mapped) {
 		view->mapped = false;
 		wlr_scene_node_set_enabled(&view->scene_tree->node, false);
+		view->server->scene_generation++;
+		visibility_arm_fallback(view->server);
+		hit_index_view_damage(view);
 		wl_list_remove(&view->commit.link);
 		desktop_focus_topmost_mapped_view(view->server);
 	}
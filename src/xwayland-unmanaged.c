@@ -16,6 +16,7 @@ unmanaged_handle_request_configure(struct wl_listener *listener, void *data)
 	wlr_xwayland_surface_configure(xsurface, ev->x, ev->y, ev->width, ev->height);
 	if (unmanaged->node) {
 		wlr_scene_node_set_position(unmanaged->node, ev->x, ev->y);
+		unmanaged->server->scene_generation++;
 		cursor_update_focus(unmanaged->server);
 	}
 }
@@ -28,6 +29,7 @@ unmanaged_handle_set_geometry(struct wl_listener *listener, void *data)
 	struct wlr_xwayland_surface *xsurface = unmanaged->xwayland_surface;
 	if (unmanaged->node) {
 		wlr_scene_node_set_position(unmanaged->node, xsurface->x, xsurface->y);
+		unmanaged->server->scene_generation++;
 		cursor_update_focus(unmanaged->server);
 	}
 }
@@ -56,6 +58,7 @@ unmanaged_handle_map(struct wl_listener *listener, void *data)
 			unmanaged->server->unmanaged_tree,
 			xsurface->surface)->buffer->node;
 	wlr_scene_node_set_position(unmanaged->node, xsurface->x, xsurface->y);
+	unmanaged->server->scene_generation++;
 	cursor_update_focus(unmanaged->server);
 }
 
@@ -109,6 +112,7 @@ unmanaged_handle_unmap(struct wl_listener *listener, void *data)
 	 * won't try to reposition the node while unmapped.
 	 */
 	unmanaged->node = NULL;
+	unmanaged->server->scene_generation++;
 	cursor_update_focus(unmanaged->server);
 
 	if (seat->seat->keyboard_state.focused_surface == xsurface->surface) {
@@ -4,11 +4,13 @@
 #include <stdlib.h>
 #include <wlr/xwayland.h>
 #include "common/mem.h"
+#include "hit-index.h"
 #include "labwc.h"
 #include "node.h"
 #include "ssd.h"
 #include "view.h"
 #include "view-impl-common.h"
+#include "visibility.h"
 #include "window-rules.h"
 #include "workspaces.h"
 #include "xwayland.h"
@@ -141,6 +143,11 @@ handle_commit(struct wl_listener *listener, void *data)
 {
 	struct view *view = wl_container_of(listener, view, commit);
 	assert(data && data == view->surface);
+	/* Plain buffer updates do not change what is under the cursor */
+	if (hit_index_view_damage(view)) {
+		view->server->scene_generation++;
+	}
+	visibility_view_commit(view);
 
 	/* Must receive commit signal before accessing surface->current* */
 	struct wlr_surface_state *state = &view->surface->current;
@@ -472,8 +479,11 @@ xwayland_view_map(struct view *view)
 		return;
 	}
 	view->mapped = true;
+	visibility_arm_fallback(view->server);
+	hit_index_view_damage(view);
 	ensure_initial_geometry_and_output(view);
 	wlr_scene_node_set_enabled(&view->scene_tree->node, true);
+	view->server->scene_generation++;
 	if (!view->fullscreen && xwayland_surface->fullscreen) {
 		view_set_fullscreen(view, true);
 	}
@@ -541,6 +551,9 @@ xwayland_view_unmap(struct view *view, bool client_request)
 	view->mapped = false;
 	wl_list_remove(&view->commit.link);
 	wlr_scene_node_set_enabled(&view->scene_tree->node, false);
+	view->server->scene_generation++;
+	visibility_arm_fallback(view->server);
+	hit_index_view_damage(view);
 	desktop_focus_topmost_mapped_view(view->server);
 
 	/*